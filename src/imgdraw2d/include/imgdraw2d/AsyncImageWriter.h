@@ -0,0 +1,109 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef IMGDRAW2D_INCLUDE_ASYNCIMAGEWRITER_H_
+#define IMGDRAW2D_INCLUDE_ASYNCIMAGEWRITER_H_
+
+#include "imgdraw2d/Image.h"
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Saves images on background threads.
+     *
+     * Writer takes ownership of queued images. Queue is bounded: if it is full,
+     * then save() blocks until one of queued images is taken by worker.
+     * Destructor waits until all queued images are saved.
+     */
+    class AsyncImageWriter {
+    public:
+
+        /// called from worker thread, "error" is null on success,
+        /// callback should not throw -- exceptions escaping from it are ignored
+        typedef std::function< void(const std::string& path, std::exception_ptr error) > Callback;
+
+
+    private:
+
+        struct Job {
+            ImagePtr image;
+            std::string path;
+            Image::SaveOptions options;
+            std::promise<void> done;
+            Callback callback;
+        };
+
+
+        mutable std::mutex mutex;
+        std::condition_variable jobQueued;
+        std::condition_variable queueFreed;
+        std::condition_variable jobsFinished;
+        std::deque<Job> queue;
+        std::size_t capacity;
+        std::size_t activeJobs;
+        bool stopping;
+        std::vector<std::thread> workers;
+
+
+    public:
+
+        /// "threads" equal 0 means number of hardware threads, "queueCapacity" equal 0 means twice number of threads
+        AsyncImageWriter(const std::size_t threads = 0, const std::size_t queueCapacity = 0);
+
+        ~AsyncImageWriter();
+
+        AsyncImageWriter(const AsyncImageWriter&) = delete;
+        AsyncImageWriter& operator=(const AsyncImageWriter&) = delete;
+
+        /// future reports exceptions thrown while saving
+        std::future<void> save(ImagePtr image, const std::string& path, const Image::SaveOptions& options = Image::SaveOptions());
+
+        void save(ImagePtr image, const std::string& path, const Image::SaveOptions& options, const Callback& callback);
+
+        /// block until all queued images are saved
+        void wait();
+
+        /// number of queued and currently saved images
+        std::size_t pending() const;
+
+
+    private:
+
+        void enqueue(Job&& job);
+
+        void work();
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_INCLUDE_ASYNCIMAGEWRITER_H_ */
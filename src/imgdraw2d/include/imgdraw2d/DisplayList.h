@@ -0,0 +1,103 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef IMGDRAW2D_INCLUDE_DISPLAYLIST_H_
+#define IMGDRAW2D_INCLUDE_DISPLAYLIST_H_
+
+#include "imgdraw2d/Painter.h"
+
+#include <functional>
+#include <vector>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Drawing commands recorded by Painter (see Painter::setImage(DisplayList&)).
+     *
+     * Commands can be replayed on any part of canvas, so scene can be rendered
+     * and encoded band by band without storing whole image in memory.
+     */
+    class DisplayList {
+    public:
+
+        /// draws primitive on target, "offset" is position of target's top left corner on canvas
+        typedef std::function< void(painter::ModeWorker& target, const PointI& offset) > Operation;
+
+
+    private:
+
+        struct Command {
+            RectI area;                         /// bounding box on canvas (borders included)
+            Painter::CompositionMode mode;
+            Operation operation;
+        };
+
+
+        std::vector<Command> commands;
+        RectI bounds;
+        std::size_t revisionCounter;
+
+
+    public:
+
+        static const uint32_t DEFAULT_BAND_HEIGHT = 256;
+
+
+        DisplayList();
+
+        void record(const RectI& area, const Painter::CompositionMode mode, const Operation& operation);
+
+        bool empty() const {
+            return commands.empty();
+        }
+
+        std::size_t size() const {
+            return commands.size();
+        }
+
+        /// bounding box of all commands (borders included)
+        const RectI& area() const {
+            return bounds;
+        }
+
+        /// counter incremented on every change of list
+        std::size_t revision() const {
+            return revisionCounter;
+        }
+
+        void clear();
+
+        /// draw commands on target, "origin" is position of target's top left corner on canvas
+        void render(const ImageView& target, const PointI& origin) const;
+
+        /// render given area of canvas (borders included) band by band and save it as PNG,
+        /// only one band is stored in memory, palette format requires two rendering passes
+        void save(const std::string& path, const RectI& area, const Image::Pixel& background,
+                  const Image::SaveOptions& options = Image::SaveOptions(), const uint32_t bandHeight = DEFAULT_BAND_HEIGHT) const;
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_INCLUDE_DISPLAYLIST_H_ */
@@ -25,19 +25,42 @@
 #define IMGDRAW2D_INCLUDE_DRAWER2D_H_
 
 #include "Painter.h"
+#include "DisplayList.h"
 
 
 namespace imgdraw2d {
 
     /**
      * Class allowing scaling and image resize.
+     *
+     * By default coordinates are relative to top left corner of requested area, so expansion
+     * of image moves already drawn content to new position.
+     *
+     * When growth factor is greater than 1.0 coordinates are mapped to pixel grid anchored
+     * to top left corner of first requested area, so expansion of image only adds whole pixels
+     * and reserved space can be used without moving drawn pixels.
+     *
+     * In tiled mode drawing is done on TiledImage, origin of grid is origin of tiled canvas.
+     * Image is made of tiles on access.
+     *
+     * In streaming mode primitives are recorded in DisplayList using the same coordinates
+     * as in tiled mode. Saving renders and encodes image band by band.
      */
     class ImageBox {
 
         ImagePtr img;
-        RectD sizeBox;
+        RectD sizeBox;                  /// area requested by drawn elements
+        PointD origin;                  /// top left corner of requested area, pixel grid is anchored to it
+        RectI imageArea;                /// pixels of grid covered by dense image, contains "canvasArea()" and reserved space
+        mutable ImagePtr croppedImg;    /// visible part of dense image with reserved space
         Image::Pixel backgroundColor;
         double margin;
+        double growthFactor;
+        bool blank;                     /// no area requested since reset
+        std::unique_ptr<TiledImage> tiles;
+        std::unique_ptr<DisplayList> commands;
+        uint32_t bandHeight;
+        mutable std::size_t flattenRevision;    /// revision of tiles or commands stored in "img"
 
 
     public:
@@ -51,26 +74,50 @@ namespace imgdraw2d {
 
         void reset();
 
+        /// if dense image has reserved space then copy of its visible part is returned,
+        /// modifications of such copy does not affect canvas
         const Image& image() const {
-            return *(img.get());
+            return visibleImage();
         }
 
         Image& image() {
+            return visibleImage();
+        }
+
+        /// dense image with reserved space, so drawing can continue
+        Image& canvas() {
             return *(img.get());
         }
 
         ImagePtr takeImage();
 
-        void save(const std::string& path) {
-            img->save(path);
-        }
+        /// in tiled mode image is encoded directly from tiles, in streaming mode image is rendered band by band
+        void save(const std::string& path, const Image::SaveOptions& options = Image::SaveOptions());
 
         void setBackground(const std::string& color) {
-            backgroundColor = Image::convertColor( color );
+            setBackground( Image::convertColor( color ) );
         }
 
         void setBackground(const Image::Pixel& color) {
             backgroundColor = color;
+            if (tiles != nullptr)
+                tiles->setBackground( color );
+        }
+
+        /// switch between dense and tiled canvas, content is cleared
+        void setTiled(const bool enabled, const uint32_t tileSize = TiledImage::DEFAULT_TILE_SIZE);
+
+        /// returns null if tiled mode is disabled
+        TiledImage* tiledImage() {
+            return tiles.get();
+        }
+
+        /// switch between dense and streaming canvas, content is cleared
+        void setStreaming(const bool enabled, const uint32_t bandHeight = DisplayList::DEFAULT_BAND_HEIGHT);
+
+        /// returns null if streaming mode is disabled
+        DisplayList* displayList() {
+            return commands.get();
         }
 
 
@@ -81,9 +128,49 @@ namespace imgdraw2d {
         /// returns true if image instance changed, otherwise false
         bool expand(const RectD& box);
 
+        /// when image have to be expanded then additional space of (factor - 1) times size of image
+        /// is reserved in direction of expansion, so following expansions does not require reallocation
+        /// of image; value 1.0 (default) disables reservation
+        void setGrowthFactor(const double factor) {
+            growthFactor = std::max( factor, 1.0 );
+        }
+
 
     protected:
 
+        /// remove reserved space from image, in tiled and streaming mode make image from tiles or commands
+        void crop();
+
+        void flatten() const;
+
+        Image& visibleImage() const;
+
+        /// canvas origin does not depend on drawn area (tiled and streaming mode)
+        bool virtualCanvas() const {
+            return (tiles != nullptr) || (commands != nullptr);
+        }
+
+        /// grid stays in place when area expands, otherwise it is anchored to current area
+        bool anchoredGrid() const {
+            return virtualCanvas() || (growthFactor > 1.0);
+        }
+
+        /// pixels of grid covered by requested area with margin (borders included)
+        RectI canvasArea() const;
+
+        /// canvas area extended by pixels containing right and bottom border of requested area,
+        /// elements can touch these pixels, so dense image keeps them until it is cropped
+        RectI drawableArea() const;
+
+        /// position on pixel grid (relative to origin) in pixel units
+        PointD gridPosition(const double x, const double y) const;
+
+        /// expansion of area when grid is not anchored, drawn content is moved to new position
+        bool expandArea(const RectD& box);
+
+        /// allocate image of "imageArea" and paste old image at "from"
+        void replaceImage(const PointI& from);
+
         void resizeImage();
 
         void fillBackground(const RectI& gap);
@@ -101,7 +188,7 @@ namespace imgdraw2d {
         Painter painter;
 
 
-        Drawer2DBase(const double scale = 10.0, const double margin = 0.5): imgBox(scale, margin), painter( imgBox.image() ) {
+        Drawer2DBase(const double scale = 10.0, const double margin = 0.5): imgBox(scale, margin), painter( imgBox.canvas() ) {
         }
 
         const Image& image() const {
@@ -112,10 +199,13 @@ namespace imgdraw2d {
             return imgBox.image();
         }
 
+        void save(const std::string& path, const Image::SaveOptions& options = Image::SaveOptions()) {
+            imgBox.save( path, options );
+        }
+
         ImagePtr takeImage() {
             ImagePtr oldImage = imgBox.takeImage();
-            Image& img = imgBox.image();
-            painter.setImage( img );
+            updatePainter();
             return oldImage;
         }
 
@@ -127,6 +217,24 @@ namespace imgdraw2d {
             imgBox.setBackground( color );
         }
 
+        void setGrowthFactor(const double factor) {
+            imgBox.setGrowthFactor( factor );
+        }
+
+        /// draw on canvas made of tiles, so expansion of canvas does not move drawn content,
+        /// content of canvas is cleared
+        void setTiled(const bool enabled, const uint32_t tileSize = TiledImage::DEFAULT_TILE_SIZE) {
+            imgBox.setTiled( enabled, tileSize );
+            updatePainter();
+        }
+
+        /// record drawn primitives, so image can be rendered and saved band by band
+        /// with memory proportional to width of image, content of canvas is cleared
+        void setStreaming(const bool enabled, const uint32_t bandHeight = DisplayList::DEFAULT_BAND_HEIGHT) {
+            imgBox.setStreaming( enabled, bandHeight );
+            updatePainter();
+        }
+
         void resizeImage(const double radius) {
             const RectD bbox( -radius, -radius, radius, radius );
             imgBox.resize( bbox );
@@ -148,11 +256,28 @@ namespace imgdraw2d {
 
         void extendImage(const RectD& box) {
             if (imgBox.expand(box)) {
-                Image& img = imgBox.image();
-                painter.setImage( img );
+                updatePainter();
             }
         }
 
+
+    protected:
+
+        void updatePainter() {
+            TiledImage* tiles = imgBox.tiledImage();
+            if (tiles != nullptr) {
+                painter.setImage( *tiles );
+                return ;
+            }
+            DisplayList* commands = imgBox.displayList();
+            if (commands != nullptr) {
+                painter.setImage( *commands );
+                return ;
+            }
+            Image& img = imgBox.canvas();
+            painter.setImage( img );
+        }
+
     };
 
 
@@ -222,6 +347,26 @@ namespace imgdraw2d {
             painter.fillRect( a, b, c, d, drawColor );
         }
 
+        void fillPolygon(const std::vector<PointT>& polygon) {
+            if (polygon.empty())
+                return ;
+
+            if (autoResize) {
+                RectD bbox = RectD::minmax(polygon.front(), polygon.front());
+                for( const PointT& point: polygon ) {
+                    bbox.expand( point[0], point[1] );
+                }
+                extendImage( bbox );
+            }
+
+            std::vector<PointI> points;
+            points.reserve( polygon.size() );
+            for( const PointT& point: polygon ) {
+                points.push_back( imgBox.transformCoords( point[0], point[1] ) );
+            }
+            painter.fillPolygon( points, drawColor );
+        }
+
         void fillRect(const PointT& bottomLeft, const double width, const double height) {
             if (autoResize) {
                 const PointT topRight = bottomLeft + PointT(width, height);
@@ -412,6 +412,10 @@ namespace imgdraw2d {
         Rect(const Point<T>& pointA, const Point<T>& pointB): a(pointA), b(pointB) {
         }
 
+        bool operator==(const Rect<T>& other) const {
+            return (a == other.a) && (b == other.b);
+        }
+
         T width() const {
             return b.x - a.x;
         }
@@ -419,6 +423,15 @@ namespace imgdraw2d {
             return b.y - a.y;
         }
 
+        /// returns true if given box is inside current box (borders included)
+        bool contains(const Rect<T>& box) const {
+            if (box.a.x < a.x || box.a.y < a.y)
+                return false;
+            if (box.b.x > b.x || box.b.y > b.y)
+                return false;
+            return true;
+        }
+
         void expand(const T radius) {
             Point<T> r{radius, radius};
             a -= r;
@@ -506,6 +519,23 @@ namespace imgdraw2d {
     /// ========================================================
 
 
+    /// rounds quotient towards negative infinity
+    inline int64_t floorDiv(const int64_t value, const int64_t divisor) {
+        const int64_t quotient = value / divisor;
+        if ( (value % divisor != 0) && ((value < 0) != (divisor < 0)) )
+            return quotient - 1;
+        return quotient;
+    }
+
+    /// rounds quotient towards positive infinity
+    inline int64_t ceilDiv(const int64_t value, const int64_t divisor) {
+        return -floorDiv( -value, divisor );
+    }
+
+
+    /// ========================================================
+
+
     struct Linear {
         typedef PointI::value_type value_type;
 
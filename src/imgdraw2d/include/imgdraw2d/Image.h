@@ -24,10 +24,14 @@
 #ifndef IMGDRAW2D_INCLUDE_IMAGE_H_
 #define IMGDRAW2D_INCLUDE_IMAGE_H_
 
+#include "imgdraw2d/PixelBuffer.h"
+
 #include <png++/png.hpp>
 
 #include <string>
+#include <vector>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 
 
@@ -35,6 +39,12 @@ namespace imgdraw2d {
 
     class Image;
 
+    class ConstImageView;
+
+    class ImagePool;
+
+    class PngReader;
+
     typedef std::unique_ptr<Image> ImagePtr;
 
 
@@ -45,12 +55,76 @@ namespace imgdraw2d {
         typedef png::basic_rgba_pixel< PixByte > Pixel;
         typedef png::image< Pixel > RawImage;
 
-//        typedef RawImage::row_access row_access;
-//        typedef RawImage::row_const_access row_const_access;
-
-        /// compatibility with version 0.2.5 (Ubuntu 16)
-        typedef RawImage::pixbuf::row_type& row_access;
-        typedef RawImage::pixbuf::row_type const& row_const_access;
+        /// layout of pixels in saved file, pixels in memory are always stored as RGBA
+        enum PixelFormat {
+            PF_GRAY8,                   /// 8-bit luminance
+            PF_GRAY_ALPHA,              /// 8-bit luminance and alpha
+            PF_RGB24,                   /// 8-bit color channels, alpha is dropped
+            PF_RGBA32,                  /// 8-bit color channels and alpha
+            PF_PALETTE8,                /// indexes of up to 256 colors, 1, 2, 4 or 8 bits depending on number of colors
+            PF_AUTO                     /// PF_PALETTE8 if image contains up to 256 colors, PF_RGBA32 otherwise
+        };
+
+        /// settings of PNG encoder
+        struct SaveOptions {
+
+            /// zlib compression strategy
+            enum Strategy {
+                ZS_DEFAULT,
+                ZS_FILTERED,
+                ZS_HUFFMAN_ONLY,
+                ZS_RLE,
+                ZS_FIXED
+            };
+
+            /// row filters, values can be combined, encoder selects best filter for each row
+            enum Filter {
+                FILTER_DEFAULT = 0x00,              /// let libpng decide
+                FILTER_NONE    = 0x08,
+                FILTER_SUB     = 0x10,
+                FILTER_UP      = 0x20,
+                FILTER_AVG     = 0x40,
+                FILTER_PAETH   = 0x80,
+                FILTER_ALL     = 0xF8
+            };
+
+
+            PixelFormat format;
+            int compressionLevel;               /// from 0 (no compression) to 9 (best), -1 means zlib default
+            Strategy strategy;
+            int filters;                        /// combination of Filter values
+            unsigned threads;                   /// number of compression threads, 0 means number of hardware threads
+
+
+            SaveOptions(const PixelFormat format = PF_RGBA32):
+                format(format), compressionLevel(-1), strategy(ZS_DEFAULT), filters(FILTER_DEFAULT), threads(1)
+            {
+            }
+
+            /// fast encoding for flat color images: RLE without filtering
+            static SaveOptions fast(const PixelFormat format = PF_RGBA32) {
+                SaveOptions options( format );
+                options.compressionLevel = 1;
+                options.strategy = ZS_RLE;
+                options.filters = FILTER_NONE;
+                return options;
+            }
+
+            /// smallest files, slowest encoding
+            static SaveOptions compact(const PixelFormat format = PF_RGBA32) {
+                SaveOptions options( format );
+                options.compressionLevel = 9;
+                options.filters = FILTER_ALL;
+                return options;
+            }
+        };
+
+        /// pointer to first pixel of row, rows are stored in one contiguous buffer
+        typedef Pixel* row_access;
+        typedef const Pixel* row_const_access;
+
+        /// row stride is multiple of this value, so each row starts on aligned address
+        static const std::size_t STRIDE_ALIGNMENT = PixelBuffer::ALIGNMENT / sizeof(Pixel);
 
 
         static const Pixel TRANSPARENT;
@@ -64,7 +138,12 @@ namespace imgdraw2d {
 
     protected:
 
-        RawImage img;
+        PixelBuffer buffer;
+        uint32_t imgWidth;
+        uint32_t imgHeight;
+        std::size_t imgStride;          /// number of pixels between beginnings of consecutive rows
+
+        std::weak_ptr<ImagePool> pool;          /// source of buffers, can be empty
 
 
     public:
@@ -73,6 +152,16 @@ namespace imgdraw2d {
 
         Image(const uint32_t width, const uint32_t height);
 
+        Image(const Image& image);
+
+        Image(Image&& image);
+
+        ~Image();
+
+        Image& operator=(const Image& image);
+
+        Image& operator=(Image&& image);
+
         bool operator==(const Image& image) const {
             return equals(image);
         }
@@ -80,19 +169,40 @@ namespace imgdraw2d {
             return !equals(image);
         }
 
+        /// compares sizes and then pixels row by row, stops on first difference
         bool equals(const Image& image) const;
 
+        /// hash of size and content, calculated on each call (visits all pixels)
+        uint64_t hash() const;
+
         bool empty() const;
 
         uint32_t width() const;
 
         uint32_t height() const;
 
-        // row_const_access is reference to "row" type
-        row_const_access row(const std::size_t y) const;
+        /// number of pixels between beginnings of consecutive rows
+        std::size_t stride() const {
+            return imgStride;
+        }
+
+        /// pointer to first pixel of first row
+        const Pixel* data() const {
+            return reinterpret_cast<const Pixel*>( buffer.data() );
+        }
+
+        /// pointer to first pixel of first row
+        Pixel* data() {
+            return reinterpret_cast<Pixel*>( buffer.data() );
+        }
+
+        row_const_access row(const std::size_t y) const {
+            return data() + y * imgStride;
+        }
 
-        // row_access is reference to "row" type
-        row_access row(const std::size_t y);
+        row_access row(const std::size_t y) {
+            return reinterpret_cast<Pixel*>( buffer.data() ) + y * imgStride;
+        }
 
         const Pixel& pixel(const std::size_t x, const std::size_t y) const;
 
@@ -110,12 +220,40 @@ namespace imgdraw2d {
 
         void pasteImage(const std::size_t x, const std::size_t y, const Image& source );
 
+        void pasteImage(const std::size_t x, const std::size_t y, const ConstImageView& source );
+
+        /// load file, format is selected by extension (see ImageCodec), PNG is default,
+        /// returns false on failure, image is left untouched in such case
         bool load(const std::string& path);
 
-        void save(const std::string& path);
+        /// save image in format selected by extension (see ImageCodec), PNG is default,
+        /// PNG is saved with given pixel format (options are implicitly created from PixelFormat),
+        /// conversion to gray formats uses ITU-R BT.601 luma,
+        /// saving with PF_PALETTE8 throws std::invalid_argument if image contains more than 256 colors,
+        /// PF_AUTO falls back to PF_RGBA32 in such case
+        void save(const std::string& path, const SaveOptions& options = SaveOptions());
+
+        /// decode PNG stream from memory, returns false on failure, image is left untouched in such case
+        bool decodePng(const void* data, const std::size_t size);
+
+        /// encode image as PNG in memory, stream replaces content of "output"
+        void encodePng(std::vector<uint8_t>& output, const SaveOptions& options = SaveOptions()) const;
+
+        /// load uncompressed image saved by saveRaw(), returns false on failure
+        bool loadRaw(const std::string& path);
 
+        /// save uncompressed pixels with header (see MappedImage), buffer is written in one system call
+        void saveRaw(const std::string& path) const;
+
+        /// content of common area is preserved, new pixels are transparent
         void resize(const std::size_t width, const std::size_t height);
 
+        /// leave only given area (clipped to image size), operation is done in place without reallocation
+        void crop(const std::size_t x, const std::size_t y, const std::size_t width, const std::size_t height);
+
+        /// buffers will be taken from and returned to given pool
+        void setPool(const std::shared_ptr<ImagePool>& imagePool);
+
 
         static ImagePtr make() {
             return ImagePtr( new Image() );
@@ -126,33 +264,32 @@ namespace imgdraw2d {
 
     private:
 
-        bool compare(const RawImage& image) const;
+        bool compare(const Image& image) const;
+
+        /// load file, throws std::runtime_error on failure
+        void read(const std::string& path);
+
+        /// decode rows of PNG into new buffer, current buffer is replaced after all rows are decoded
+        void decode(PngReader& reader);
+
+        /// allocates buffer using pool if available
+        PixelBuffer allocate(const std::size_t size) const;
+
+        /// replaces current buffer returning old one to pool
+        void replaceBuffer(PixelBuffer&& newBuffer);
+
+        static std::size_t calculateStride(const std::size_t width);
 
     };
 
 
+    /// compare all channels at once
     inline bool operator==(const imgdraw2d::Image::Pixel& colorA, const imgdraw2d::Image::Pixel& colorB) {
-        if ( colorA.red != colorB.red )
-            return false;
-        if ( colorA.green != colorB.green )
-            return false;
-        if ( colorA.blue != colorB.blue )
-            return false;
-        if ( colorA.alpha != colorB.alpha )
-            return false;
-        return true;
+        return ( std::memcmp( &colorA, &colorB, sizeof(imgdraw2d::Image::Pixel) ) == 0 );
     }
 
     inline bool operator!=(const imgdraw2d::Image::Pixel& colorA, const imgdraw2d::Image::Pixel& colorB) {
-        if ( colorA.red != colorB.red )
-            return true;
-        if ( colorA.green != colorB.green )
-            return true;
-        if ( colorA.blue != colorB.blue )
-            return true;
-        if ( colorA.alpha != colorB.alpha )
-            return true;
-        return false;
+        return ( std::memcmp( &colorA, &colorB, sizeof(imgdraw2d::Image::Pixel) ) != 0 );
     }
 
 } /* namespace imgdraw2d */
@@ -0,0 +1,132 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_INCLUDE_IMAGECACHE_H_
+#define IMGDRAW2D_INCLUDE_IMAGECACHE_H_
+
+#include "imgdraw2d/Image.h"
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Cache of images decoded from files.
+     *
+     * Entries are identified by path, modification time and size of file,
+     * so changed file is decoded again. Least recently used images are
+     * removed when memory limit is exceeded. Cache is thread-safe.
+     */
+    class ImageCache {
+    public:
+
+        typedef std::shared_ptr<const Image> ImageConstPtr;
+
+
+    private:
+
+        /// identity of file content
+        struct FileStamp {
+            int64_t modified;                   /// nanoseconds
+            int64_t size;
+
+            bool operator==(const FileStamp& stamp) const {
+                return modified == stamp.modified && size == stamp.size;
+            }
+        };
+
+        struct Entry {
+            std::string path;
+            FileStamp stamp;
+            ImageConstPtr image;
+            std::size_t bytes;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        mutable std::mutex mutex;
+        EntryList entries;                                                  /// most recently used first
+        std::unordered_map<std::string, EntryList::iterator> index;         /// path -> entry
+        std::size_t cachedBytes;
+        std::size_t capacity;
+
+
+    public:
+
+        static const std::size_t DEFAULT_CAPACITY = 256 * 1024 * 1024;
+
+
+        ImageCache(const ImageCache&) = delete;
+        ImageCache& operator=(const ImageCache&) = delete;
+
+        /// cache keeping no more than "capacity" bytes of pixels
+        static std::shared_ptr<ImageCache> make(const std::size_t capacity = DEFAULT_CAPACITY);
+
+        /// cache shared by library internals (e.g. ImageComparator)
+        static std::shared_ptr<ImageCache> global();
+
+
+        /// returns decoded image, file is decoded only if it is not cached or it changed,
+        /// returns null if file can not be loaded
+        ImageConstPtr load(const std::string& path);
+
+        /// remove entry of given file
+        void remove(const std::string& path);
+
+        /// remove all entries
+        void clear();
+
+        /// set limit of cached memory, least recently used images are removed if limit is exceeded
+        void setCapacity(const std::size_t bytes);
+
+        /// number of cached bytes of pixels
+        std::size_t size() const;
+
+        /// number of cached images
+        std::size_t count() const;
+
+
+    protected:
+
+        ImageCache(const std::size_t capacity);
+
+
+    private:
+
+        static bool fileStamp(const std::string& path, FileStamp& stamp);
+
+        /// removes least recently used entries until memory limit is satisfied, requires locked mutex
+        void shrink();
+
+        /// requires locked mutex
+        void erase(EntryList::iterator entry);
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_INCLUDE_IMAGECACHE_H_ */
@@ -0,0 +1,90 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_INCLUDE_IMAGECODEC_H_
+#define IMGDRAW2D_INCLUDE_IMAGECODEC_H_
+
+#include "imgdraw2d/Image.h"
+
+#include <vector>
+#include <string>
+
+
+namespace imgdraw2d {
+
+    class ImageCodec;
+
+    typedef std::shared_ptr<const ImageCodec> ImageCodecPtr;
+
+
+    /**
+     * Encoder and decoder of image file format.
+     *
+     * Image::load() and Image::save() select codec by extension of file.
+     * Registered formats: PNG (default), QOI, PPM/PGM and PAM.
+     */
+    class ImageCodec {
+    public:
+
+        virtual ~ImageCodec() {
+        }
+
+        /// name of format
+        virtual std::string name() const = 0;
+
+        /// decode stream into image, returns false on failure, image is left untouched in such case
+        virtual bool decode(const void* data, const std::size_t size, Image& image) const = 0;
+
+        /// encode image, stream replaces content of "output",
+        /// options not supported by format are ignored
+        virtual void encode(const Image& image, std::vector<uint8_t>& output, const Image::SaveOptions& options) const = 0;
+
+
+        /// codec assigned to extension of given path (case insensitive), PNG codec if extension is unknown
+        static ImageCodecPtr find(const std::string& path);
+
+        /// assign codec to extension (without dot), previous codec of extension is replaced
+        static void registerCodec(const std::string& extension, const ImageCodecPtr& codec);
+
+        static ImageCodecPtr png();
+
+        static ImageCodecPtr qoi();
+
+        /// binary PPM (P6), alpha channel is dropped, PGM (P5) files can be also decoded
+        static ImageCodecPtr ppm();
+
+        /// PAM (P7) with RGB_ALPHA tuples
+        static ImageCodecPtr pam();
+
+
+    protected:
+
+        /// prepare image for decoding, content of image is undefined
+        static void prepare(Image& image, const uint32_t width, const uint32_t height);
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_INCLUDE_IMAGECODEC_H_ */
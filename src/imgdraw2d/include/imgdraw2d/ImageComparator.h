@@ -25,6 +25,7 @@
 #define IMAGE_COMPARATOR_H_
 
 #include "imgdraw2d/Image.h"
+#include "imgdraw2d/ImageView.h"
 
 #include <string>
 
@@ -34,11 +35,18 @@ namespace imgdraw2d {
     class ImageComparator {
     public:
 
-        static ImagePtr compare(const Image& imgA, const Image& imgB);
+        /// returns image presenting differences between given images
+        static ImagePtr compare(const ConstImageView& imgA, const ConstImageView& imgB);
+
+        static ImagePtr compare(const Image& imgA, const Image& imgB) {
+            return compare( ConstImageView(imgA), ConstImageView(imgB) );
+        }
 
         static ImagePtr compare(const Image* imgA, const Image* imgB);
 
         /// returns true if images are the same, otherwise false
+        static bool compare(const ConstImageView& imgA, const ConstImageView& imgB, const std::string& diffImage);
+
         static bool compare(const Image& imgA, const Image& imgB, const std::string& diffImage);
 
         static bool compare(const Image& imgA, const std::string& imgB, const std::string& diffImage);
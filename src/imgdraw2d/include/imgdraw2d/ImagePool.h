@@ -0,0 +1,98 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_INCLUDE_IMAGEPOOL_H_
+#define IMGDRAW2D_INCLUDE_IMAGEPOOL_H_
+
+#include "imgdraw2d/Image.h"
+
+#include <map>
+#include <vector>
+#include <mutex>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Cache of pixel buffers allowing to reuse memory of destroyed images.
+     *
+     * Buffers are grouped by size classes (four classes per power of two).
+     * Images created by the pool return their buffers to the pool on destruction
+     * and on resize. Pool can be safely destroyed before its images.
+     */
+    class ImagePool: public std::enable_shared_from_this<ImagePool> {
+
+        mutable std::mutex mutex;
+        std::map< std::size_t, std::vector<PixelBuffer> > buffers;        /// size class -> free buffers
+        std::size_t cachedBytes;
+        std::size_t capacity;
+
+
+    public:
+
+        static const std::size_t DEFAULT_CAPACITY = 256 * 1024 * 1024;
+
+
+        /// pool caching no more than "capacity" bytes
+        static std::shared_ptr<ImagePool> make(const std::size_t capacity = DEFAULT_CAPACITY);
+
+        /// pool shared by library internals
+        static std::shared_ptr<ImagePool> global();
+
+
+        /// empty image connected to the pool
+        ImagePtr makeImage();
+
+        /// transparent image connected to the pool
+        ImagePtr makeImage(const uint32_t width, const uint32_t height);
+
+        /// returns buffer of at least "size" bytes, content of buffer is undefined
+        PixelBuffer acquire(const std::size_t size);
+
+        /// store buffer for future use, buffer is freed if capacity is exceeded
+        void release(PixelBuffer&& buffer);
+
+        /// free all cached buffers
+        void clear();
+
+        /// set limit of cached memory, exceeding buffers are freed
+        void setCapacity(const std::size_t bytes);
+
+        std::size_t size() const;
+
+        static std::size_t sizeClass(const std::size_t size);
+
+
+    protected:
+
+        ImagePool(const std::size_t capacity);
+
+        /// removes biggest buffers until memory limit is satisfied, requires locked mutex
+        void shrink();
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_INCLUDE_IMAGEPOOL_H_ */
@@ -0,0 +1,211 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_INCLUDE_IMAGEVIEW_H_
+#define IMGDRAW2D_INCLUDE_IMAGEVIEW_H_
+
+#include "imgdraw2d/Image.h"
+
+#include <algorithm>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Non-owning read-only access to rectangular region of image or of external RGBA buffer.
+     */
+    class ConstImageView {
+    public:
+
+        typedef Image::Pixel Pixel;
+        typedef Image::row_const_access row_const_access;
+
+
+    protected:
+
+        const Pixel* origin;            /// top-left pixel of region
+        uint32_t viewWidth;
+        uint32_t viewHeight;
+        std::size_t viewStride;         /// number of pixels between beginnings of consecutive rows
+
+
+    public:
+
+        ConstImageView(): origin(nullptr), viewWidth(0), viewHeight(0), viewStride(0) {
+        }
+
+        ConstImageView(const Pixel* data, const uint32_t width, const uint32_t height, const std::size_t stride):
+            origin(data), viewWidth(width), viewHeight(height), viewStride(stride)
+        {
+        }
+
+        ConstImageView(const Image& image):
+            origin(image.data()), viewWidth(image.width()), viewHeight(image.height()), viewStride(image.stride())
+        {
+        }
+
+        /// region is clipped to image size
+        ConstImageView(const Image& image, const std::size_t x, const std::size_t y, const std::size_t width, const std::size_t height):
+            ConstImageView( ConstImageView(image).region(x, y, width, height) )
+        {
+        }
+
+        bool empty() const {
+            return (viewWidth == 0 || viewHeight == 0);
+        }
+
+        uint32_t width() const {
+            return viewWidth;
+        }
+
+        uint32_t height() const {
+            return viewHeight;
+        }
+
+        std::size_t stride() const {
+            return viewStride;
+        }
+
+        const Pixel* data() const {
+            return origin;
+        }
+
+        row_const_access row(const std::size_t y) const {
+            return origin + y * viewStride;
+        }
+
+        const Pixel& pixel(const std::size_t x, const std::size_t y) const {
+            return row(y)[x];
+        }
+
+        /// region is clipped to view size
+        ConstImageView region(const std::size_t x, const std::size_t y, const std::size_t width, const std::size_t height) const {
+            if (x >= viewWidth || y >= viewHeight)
+                return ConstImageView();
+            const uint32_t w = std::min( (std::size_t) viewWidth - x, width );
+            const uint32_t h = std::min( (std::size_t) viewHeight - y, height );
+            return ConstImageView( row(y) + x, w, h, viewStride );
+        }
+
+        /// compare size and pixels of views
+        bool equals(const ConstImageView& view) const;
+
+    };
+
+
+    /**
+     * Non-owning access to rectangular region of image or of external RGBA buffer.
+     *
+     * Creating view of image invalidates its cached hash, same as any non-const access to pixels.
+     */
+    class ImageView {
+    public:
+
+        typedef Image::Pixel Pixel;
+        typedef Image::row_access row_access;
+
+
+    protected:
+
+        Pixel* origin;                  /// top-left pixel of region
+        uint32_t viewWidth;
+        uint32_t viewHeight;
+        std::size_t viewStride;         /// number of pixels between beginnings of consecutive rows
+
+
+    public:
+
+        ImageView(): origin(nullptr), viewWidth(0), viewHeight(0), viewStride(0) {
+        }
+
+        ImageView(Pixel* data, const uint32_t width, const uint32_t height, const std::size_t stride):
+            origin(data), viewWidth(width), viewHeight(height), viewStride(stride)
+        {
+        }
+
+        ImageView(Image& image):
+            origin(image.data()), viewWidth(image.width()), viewHeight(image.height()), viewStride(image.stride())
+        {
+        }
+
+        /// region is clipped to image size
+        ImageView(Image& image, const std::size_t x, const std::size_t y, const std::size_t width, const std::size_t height):
+            ImageView( ImageView(image).region(x, y, width, height) )
+        {
+        }
+
+        operator ConstImageView() const {
+            return ConstImageView( origin, viewWidth, viewHeight, viewStride );
+        }
+
+        bool empty() const {
+            return (viewWidth == 0 || viewHeight == 0);
+        }
+
+        uint32_t width() const {
+            return viewWidth;
+        }
+
+        uint32_t height() const {
+            return viewHeight;
+        }
+
+        std::size_t stride() const {
+            return viewStride;
+        }
+
+        Pixel* data() const {
+            return origin;
+        }
+
+        row_access row(const std::size_t y) const {
+            return origin + y * viewStride;
+        }
+
+        Pixel& pixel(const std::size_t x, const std::size_t y) const {
+            return row(y)[x];
+        }
+
+        /// region is clipped to view size
+        ImageView region(const std::size_t x, const std::size_t y, const std::size_t width, const std::size_t height) const {
+            if (x >= viewWidth || y >= viewHeight)
+                return ImageView();
+            const uint32_t w = std::min( (std::size_t) viewWidth - x, width );
+            const uint32_t h = std::min( (std::size_t) viewHeight - y, height );
+            return ImageView( row(y) + x, w, h, viewStride );
+        }
+
+        void fill(const Pixel& color) const;
+
+        /// fill area [sx, ex) x [sy, ey) clipped to view size
+        void fillRect(const std::size_t sx, const std::size_t sy, const std::size_t ex, const std::size_t ey, const Pixel& color ) const;
+
+        /// copy source to given position, copied area is clipped to view size
+        void pasteImage(const std::size_t x, const std::size_t y, const ConstImageView& source ) const;
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_INCLUDE_IMAGEVIEW_H_ */
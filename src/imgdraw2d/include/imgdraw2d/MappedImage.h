@@ -0,0 +1,90 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef IMGDRAW2D_INCLUDE_MAPPEDIMAGE_H_
+#define IMGDRAW2D_INCLUDE_MAPPEDIMAGE_H_
+
+#include "imgdraw2d/ImageView.h"
+
+
+namespace imgdraw2d {
+
+    /**
+     * Raw image file (see Image::saveRaw()) mapped into memory.
+     *
+     * Pixels are accessed directly from mapping without copying,
+     * view is valid until object is closed or destroyed.
+     */
+    class MappedImage {
+
+        void* mapping;
+        std::size_t mappingSize;
+        ConstImageView pixels;
+
+
+    public:
+
+        MappedImage();
+
+        /// object is empty if file can not be mapped
+        MappedImage(const std::string& path);
+
+        MappedImage(MappedImage&& image);
+
+        ~MappedImage();
+
+        MappedImage(const MappedImage&) = delete;
+        MappedImage& operator=(const MappedImage&) = delete;
+
+        MappedImage& operator=(MappedImage&& image);
+
+        /// returns false if file is missing or is not valid raw image
+        bool open(const std::string& path);
+
+        void close();
+
+        bool empty() const {
+            return (mapping == nullptr);
+        }
+
+        uint32_t width() const {
+            return pixels.width();
+        }
+
+        uint32_t height() const {
+            return pixels.height();
+        }
+
+        const ConstImageView& view() const {
+            return pixels;
+        }
+
+        operator const ConstImageView&() const {
+            return pixels;
+        }
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_INCLUDE_MAPPEDIMAGE_H_ */
@@ -25,11 +25,17 @@
 #define IMGDRAW2D_INCLUDE_PAINTER_H_
 
 #include "imgdraw2d/Image.h"
+#include "imgdraw2d/ImageView.h"
+#include "imgdraw2d/TiledImage.h"
 
 #include "imgdraw2d/Geometry.h"
 
 
 namespace imgdraw2d {
+
+    class DisplayList;
+
+
     namespace painter {
 
         class AbstractPainter {
@@ -38,7 +44,7 @@ namespace imgdraw2d {
             virtual ~AbstractPainter() {
             }
 
-            virtual void drawImage(const PointI& point, const Image& source) = 0;
+            virtual void drawImage(const PointI& point, const ConstImageView& source) = 0;
 
             void drawLine(const PointI& fromPoint, const PointI& toPoint, const uint32_t width, const std::string& color) {
                 const Image::Pixel pixColor = Image::convertColor(color);
@@ -74,6 +80,14 @@ namespace imgdraw2d {
 
             virtual void fillRect(const PointI& topLeft, const PointI& topRight, const PointI& bottomRight, const PointI& bottomLeft, const Image::Pixel& pixColor) = 0;
 
+            void fillPolygon(const std::vector<PointI>& polygon, const std::string& color) {
+                const Image::Pixel pixColor = Image::convertColor(color);
+                fillPolygon( polygon, pixColor );
+            }
+
+            /// fill pixels inside polygon (even-odd rule), pixels on right and bottom edges are not filled
+            virtual void fillPolygon(const std::vector<PointI>& polygon, const Image::Pixel& pixColor) = 0;
+
             void fillCircle(const PointI& center, const uint32_t radius, const std::string& color) {
                 const Image::Pixel pixColor = Image::convertColor(color);
                 fillCircle( center, radius, pixColor );
@@ -88,18 +102,50 @@ namespace imgdraw2d {
         public:
 
             Image* img;
+            ImageView region;               /// drawing target if "img" is not set
+            bool changed;                   /// set when pixels of target are written, reset by owner of worker
+            const Image::Pixel* blankColor; /// if set, then writing of this color does not count as change
+
 
-            ModeWorker(Image* image): img(image) {
+            ModeWorker(Image* image): img(image), region(), changed(false), blankColor(nullptr) {
+            }
+
+            ModeWorker(const ImageView& view): img(nullptr), region(view), changed(false), blankColor(nullptr) {
             }
 
             virtual void setImage(Image* image) {
                 img = image;
+                region = ImageView();
             }
 
             void setImage(Image& image) {
                 setImage( &image );
             }
 
+            /// draw on given region, coordinates are relative to region's top-left corner
+            virtual void setImage(const ImageView& view) {
+                img = nullptr;
+                region = view;
+            }
+
+            /// returns area to draw on, view of image is created on every call, so it is valid even after image resize
+            ImageView target() {
+                if (img != nullptr)
+                    return ImageView( *img );
+                return region;
+            }
+
+            /// called by drawing operations after writing visible pixels
+            void markChanged() {
+                changed = true;
+            }
+
+            /// called by drawing operations after writing visible pixels of given color
+            void markChanged(const Image::Pixel& color) {
+                if (blankColor == nullptr || color != *blankColor)
+                    changed = true;
+            }
+
             using AbstractPainter::drawImage;
 
             using AbstractPainter::drawLine;
@@ -109,7 +155,7 @@ namespace imgdraw2d {
             using AbstractPainter::fillCircle;
 
 
-            void drawImage(const uint32_t x, const uint32_t y, const Image& source) {
+            void drawImage(const uint32_t x, const uint32_t y, const ConstImageView& source) {
                 drawImage( PointI{x, y}, source );
             }
 
@@ -143,6 +189,8 @@ namespace imgdraw2d {
 
         CompositionMode mode;
         std::unique_ptr<ModeWorker> worker;
+        TiledImage* tiles;                  /// drawing target if set, primitives are split between tiles
+        DisplayList* recorder;              /// drawing target if set, primitives are recorded instead of drawn
 
 
     public:
@@ -151,13 +199,46 @@ namespace imgdraw2d {
 
         Painter(Image* image);
 
+        Painter(const ImageView& view);
+
+        Painter(TiledImage& canvas);
+
+        Painter(DisplayList& commands);
+
         void setImage(Image* image) override {
+            tiles = nullptr;
+            recorder = nullptr;
             ModeWorker::setImage( image );
             worker->setImage( image );
         }
 
+        void setImage(const ImageView& view) override {
+            tiles = nullptr;
+            recorder = nullptr;
+            ModeWorker::setImage( view );
+            worker->setImage( view );
+        }
+
+        /// draw on tiled canvas, coordinates are relative to canvas origin and can be negative
+        void setImage(TiledImage& canvas) {
+            ModeWorker::setImage( ImageView() );
+            tiles = &canvas;
+            recorder = nullptr;
+        }
+
+        /// record primitives instead of drawing them, coordinates are relative to canvas origin and can be negative
+        void setImage(DisplayList& commands) {
+            ModeWorker::setImage( ImageView() );
+            tiles = nullptr;
+            recorder = &commands;
+        }
+
         using painter::ModeWorker::setImage;
 
+        CompositionMode compositionMode() const {
+            return mode;
+        }
+
         void setCompositionMode(const CompositionMode mode);
 
         // ====================================================================
@@ -168,6 +249,8 @@ namespace imgdraw2d {
 
         using painter::ModeWorker::fillRect;
 
+        using painter::ModeWorker::fillPolygon;
+
         using painter::ModeWorker::fillCircle;
 
         using painter::ModeWorker::drawRing;
@@ -175,33 +258,30 @@ namespace imgdraw2d {
         using painter::ModeWorker::drawArc;
 
 
-        void drawImage(const PointI& point, const Image& source) override {
-            worker->drawImage(point, source);
-        }
+        void drawImage(const PointI& point, const ConstImageView& source) override;
 
-        void drawLine(const PointI& fromPoint, const PointI& toPoint, const uint32_t width, const Image::Pixel& pixColor) override {
-            worker->drawLine(fromPoint, toPoint, width, pixColor);
-        }
+        void drawLine(const PointI& fromPoint, const PointI& toPoint, const uint32_t width, const Image::Pixel& pixColor) override;
 
-        void drawArc(const PointI& center, const uint32_t radius, const uint32_t width, const double startAngle, const double range, const Image::Pixel& pixColor) override {
-            worker->drawArc(center, radius, width, startAngle, range, pixColor);
-        }
+        void drawArc(const PointI& center, const uint32_t radius, const uint32_t width, const double startAngle, const double range, const Image::Pixel& pixColor) override;
 
-        void drawRing(const PointI& center, const uint32_t radius, const uint32_t width, const Image::Pixel& pixColor) override {
-            worker->drawRing(center, radius, width, pixColor);
-        }
+        void drawRing(const PointI& center, const uint32_t radius, const uint32_t width, const Image::Pixel& pixColor) override;
 
-        void fillRect(const PointI& point, const uint32_t width, const uint32_t height, const Image::Pixel& pixColor) override {
-            worker->fillRect(point, width, height, pixColor);
-        }
+        void fillRect(const PointI& point, const uint32_t width, const uint32_t height, const Image::Pixel& pixColor) override;
 
-        void fillRect(const PointI& topLeft, const PointI& topRight, const PointI& bottomRight, const PointI& bottomLeft, const Image::Pixel& pixColor) override {
-            worker->fillRect(topLeft, topRight, bottomRight, bottomLeft, pixColor);
-        }
+        void fillRect(const PointI& topLeft, const PointI& topRight, const PointI& bottomRight, const PointI& bottomLeft, const Image::Pixel& pixColor) override;
 
-        void fillCircle(const PointI& center, const uint32_t radius, const Image::Pixel& pixColor) override {
-            worker->fillCircle(center, radius, pixColor);
-        }
+        void fillPolygon(const std::vector<PointI>& polygon, const Image::Pixel& pixColor) override;
+
+        void fillCircle(const PointI& center, const uint32_t radius, const Image::Pixel& pixColor) override;
+
+
+    private:
+
+        /// calls "operation" for every target covered by "area" (borders included),
+        /// operation receives target and position of target's top left corner,
+        /// in recording mode operation is stored, so it can not capture references
+        template <typename Operation>
+        void paint(const RectI& area, Operation operation);
 
     };
 
@@ -0,0 +1,89 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_INCLUDE_PIXELBUFFER_H_
+#define IMGDRAW2D_INCLUDE_PIXELBUFFER_H_
+
+#include <cstdint>
+#include <cstddef>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Contiguous block of memory with beginning aligned to ALIGNMENT bytes.
+     */
+    class PixelBuffer {
+
+        uint8_t* memory;                /// pointer returned by allocator
+        uint8_t* aligned;               /// first aligned byte inside "memory"
+        std::size_t capacity;
+
+
+    public:
+
+        /// size of cache line and of widest SIMD register
+        static const std::size_t ALIGNMENT = 64;
+
+
+        PixelBuffer(): memory(nullptr), aligned(nullptr), capacity(0) {
+        }
+
+        explicit PixelBuffer(const std::size_t size);
+
+        PixelBuffer(const PixelBuffer&) = delete;
+
+        PixelBuffer(PixelBuffer&& other);
+
+        ~PixelBuffer();
+
+        PixelBuffer& operator=(const PixelBuffer&) = delete;
+
+        PixelBuffer& operator=(PixelBuffer&& other);
+
+        uint8_t* data() {
+            return aligned;
+        }
+
+        const uint8_t* data() const {
+            return aligned;
+        }
+
+        std::size_t size() const {
+            return capacity;
+        }
+
+        bool empty() const {
+            return (capacity == 0);
+        }
+
+        void swap(PixelBuffer& other);
+
+        void clear();
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_INCLUDE_PIXELBUFFER_H_ */
@@ -0,0 +1,151 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef IMGDRAW2D_INCLUDE_TILEDIMAGE_H_
+#define IMGDRAW2D_INCLUDE_TILEDIMAGE_H_
+
+#include "imgdraw2d/Image.h"
+#include "imgdraw2d/ImageView.h"
+#include "imgdraw2d/Geometry.h"
+
+#include <map>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Canvas divided into square tiles of fixed size.
+     *
+     * Tiles are addressed by signed indices, so pixel coordinates can be negative
+     * and canvas can grow in any direction without moving already drawn pixels.
+     *
+     * Storage is sparse: not allocated tiles are treated as filled with background color.
+     * Drawing is done through acquireTile()/commitTile(), so tile is allocated only if
+     * any of its pixels was changed.
+     */
+    class TiledImage {
+    public:
+
+        typedef std::pair<int64_t, int64_t> TileKey;                /// (row, column) -- map is ordered row by row
+        typedef std::map<TileKey, ImagePtr> TilesMap;
+
+
+    private:
+
+        uint32_t tileSide;
+        Image::Pixel backgroundColor;
+        TilesMap tiles;
+        std::size_t revisionCounter;
+        ImagePtr scratch;                       /// substitute of not allocated tile, filled with background
+
+
+    public:
+
+        static const uint32_t DEFAULT_TILE_SIZE = 256;
+
+
+        TiledImage(const uint32_t tileSize = DEFAULT_TILE_SIZE, const Image::Pixel& background = Image::TRANSPARENT);
+
+        uint32_t tileSize() const {
+            return tileSide;
+        }
+
+        const Image::Pixel& background() const {
+            return backgroundColor;
+        }
+
+        /// color of tiles allocated from now on and of not allocated area
+        void setBackground(const Image::Pixel& color) {
+            backgroundColor = color;
+            scratch.reset();
+        }
+
+        /// number of allocated tiles
+        std::size_t size() const {
+            return tiles.size();
+        }
+
+        bool empty() const {
+            return tiles.empty();
+        }
+
+        const TilesMap& allocated() const {
+            return tiles;
+        }
+
+        /// counter incremented on every write access to tiles
+        std::size_t revision() const {
+            return revisionCounter;
+        }
+
+        /// index of tile containing given pixel coordinate
+        int64_t tileIndex(const int64_t coord) const {
+            const int64_t side = tileSide;
+            if (coord < 0)
+                return - ( ( - coord - 1 ) / side ) - 1;
+            return coord / side;
+        }
+
+        /// pixel coordinates of top left corner of tile
+        PointI tileOrigin(const int64_t column, const int64_t row) const {
+            const int64_t side = tileSide;
+            return PointI( column * side, row * side );
+        }
+
+        /// range of tile indices (inclusive) covering given pixel area
+        RectI tileRange(const RectI& area) const {
+            return RectI( tileIndex(area.a.x), tileIndex(area.a.y), tileIndex(area.b.x), tileIndex(area.b.y) );
+        }
+
+        /// access tile for writing, allocates tile if needed
+        Image& tile(const int64_t column, const int64_t row);
+
+        /// access tile for drawing, not allocated tile is substituted by scratch tile filled with background,
+        /// each call has to be followed by commitTile() with the same indices
+        Image& acquireTile(const int64_t column, const int64_t row);
+
+        /// keeps scratch tile returned by acquireTile() if any of its pixels was changed,
+        /// "changed" is reported by caller, so tile does not have to be scanned
+        void commitTile(const int64_t column, const int64_t row, const bool changed);
+
+        /// returns null if tile is not allocated
+        const Image* findTile(const int64_t column, const int64_t row) const;
+
+        /// copy area starting at pixel "origin" into "target", not allocated area is filled with background
+        void flatten(const ImageView& target, const PointI& origin) const;
+
+        /// image of given area (borders included)
+        ImagePtr flatten(const RectI& area) const;
+
+        /// save given area (borders included) as PNG, image is encoded in bands of tile height,
+        /// so only one band is stored in memory at once
+        void save(const std::string& path, const RectI& area, const Image::SaveOptions& options = Image::SaveOptions()) const;
+
+        /// release all tiles
+        void clear();
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_INCLUDE_TILEDIMAGE_H_ */
@@ -0,0 +1,134 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "imgdraw2d/AsyncImageWriter.h"
+
+
+namespace imgdraw2d {
+
+    AsyncImageWriter::AsyncImageWriter(const std::size_t threads, const std::size_t queueCapacity):
+        mutex(), jobQueued(), queueFreed(), jobsFinished(), queue(), capacity(queueCapacity), activeJobs(0), stopping(false), workers()
+    {
+        std::size_t count = threads;
+        if (count == 0)
+            count = std::max( std::thread::hardware_concurrency(), 1u );
+        if (capacity == 0)
+            capacity = 2 * count;
+        for( std::size_t i=0; i<count; ++i ) {
+            workers.emplace_back( &AsyncImageWriter::work, this );
+        }
+    }
+
+    AsyncImageWriter::~AsyncImageWriter() {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            stopping = true;
+        }
+        jobQueued.notify_all();
+        for( std::thread& item: workers ) {
+            item.join();
+        }
+    }
+
+    std::future<void> AsyncImageWriter::save(ImagePtr image, const std::string& path, const Image::SaveOptions& options) {
+        Job job;
+        job.image = std::move( image );
+        job.path = path;
+        job.options = options;
+        std::future<void> result = job.done.get_future();
+        enqueue( std::move(job) );
+        return result;
+    }
+
+    void AsyncImageWriter::save(ImagePtr image, const std::string& path, const Image::SaveOptions& options, const Callback& callback) {
+        Job job;
+        job.image = std::move( image );
+        job.path = path;
+        job.options = options;
+        job.callback = callback;
+        enqueue( std::move(job) );
+    }
+
+    void AsyncImageWriter::wait() {
+        std::unique_lock<std::mutex> lock( mutex );
+        jobsFinished.wait( lock, [this]() { return queue.empty() && activeJobs == 0; } );
+    }
+
+    std::size_t AsyncImageWriter::pending() const {
+        std::lock_guard<std::mutex> lock( mutex );
+        return queue.size() + activeJobs;
+    }
+
+    void AsyncImageWriter::enqueue(Job&& job) {
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            queueFreed.wait( lock, [this]() { return queue.size() < capacity; } );
+            queue.push_back( std::move(job) );
+        }
+        jobQueued.notify_one();
+    }
+
+    void AsyncImageWriter::work() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock( mutex );
+                jobQueued.wait( lock, [this]() { return stopping || queue.empty() == false; } );
+                if (queue.empty())
+                    return ;                                    /// stopping and nothing left to save
+                job = std::move( queue.front() );
+                queue.pop_front();
+                ++activeJobs;
+            }
+            queueFreed.notify_one();
+
+            std::exception_ptr error = nullptr;
+            try {
+                if (job.image != nullptr)
+                    job.image->save( job.path, job.options );
+            } catch (...) {
+                error = std::current_exception();
+            }
+            job.image.reset();                                  /// buffer returns to pool before reporting
+
+            try {
+                if (job.callback) {
+                    job.callback( job.path, error );
+                } else if (error != nullptr) {
+                    job.done.set_exception( error );
+                } else {
+                    job.done.set_value();
+                }
+            } catch (...) {
+                /// there is no one to report to, worker has to stay alive and job has to be finished
+            }
+
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                --activeJobs;
+            }
+            jobsFinished.notify_all();
+        }
+    }
+
+} /* namespace imgdraw2d */
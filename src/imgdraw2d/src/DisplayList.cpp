@@ -0,0 +1,106 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "imgdraw2d/DisplayList.h"
+
+#include "PngWriter.h"
+
+
+namespace imgdraw2d {
+
+    DisplayList::DisplayList(): commands(), bounds(), revisionCounter(0) {
+    }
+
+    void DisplayList::record(const RectI& area, const Painter::CompositionMode mode, const Operation& operation) {
+        if (commands.empty())
+            bounds = area;
+        else
+            bounds.expand( area );
+        commands.push_back( Command{ area, mode, operation } );
+        ++revisionCounter;
+    }
+
+    void DisplayList::clear() {
+        commands.clear();
+        bounds = RectI();
+        ++revisionCounter;
+    }
+
+    void DisplayList::render(const ImageView& target, const PointI& origin) const {
+        if (target.width() < 1 || target.height() < 1)
+            return ;
+        const RectI targetArea( origin, origin + PointI( target.width() - 1, target.height() - 1 ) );
+
+        Painter painter( target );
+        for( const Command& item: commands ) {
+            const RectI& area = item.area;
+            if (area.b.x < targetArea.a.x || area.a.x > targetArea.b.x)
+                continue ;
+            if (area.b.y < targetArea.a.y || area.a.y > targetArea.b.y)
+                continue ;
+            if (painter.compositionMode() != item.mode)
+                painter.setCompositionMode( item.mode );
+            item.operation( painter, origin );
+        }
+    }
+
+    void DisplayList::save(const std::string& path, const RectI& area, const Image::Pixel& background,
+                           const Image::SaveOptions& options, const uint32_t bandHeight) const
+    {
+        PngWriter::createParentDirectory( path );
+
+        const int64_t w = area.width() + 1;
+        const int64_t h = area.height() + 1;
+        if (w < 1 || h < 1) {
+            PngWriter::writeEmpty( path, background, options );
+            return ;
+        }
+
+        const int64_t bandSize = std::min( (int64_t) std::max( bandHeight, (uint32_t) 1 ), h );
+        Image band( w, bandSize );
+
+        std::vector<Image::Pixel> palette;
+        if (PngWriter::usesPalette( options.format )) {
+            /// colors have to be known before first row is written
+            for( int64_t bandStart = area.a.y; bandStart <= area.b.y; bandStart += bandSize ) {
+                const ImageView bandView = ImageView( band ).region( 0, 0, w, std::min( bandSize, area.b.y + 1 - bandStart ) );
+                bandView.fill( background );
+                render( bandView, PointI( area.a.x, bandStart ) );
+                if (PngWriter::collectPalette( bandView, palette, options.format ) == false)
+                    break;
+            }
+        }
+
+        PngWriter writer( path, w, h, options, palette );
+        for( int64_t bandStart = area.a.y; bandStart <= area.b.y; bandStart += bandSize ) {
+            const ImageView bandView = ImageView( band ).region( 0, 0, w, std::min( bandSize, area.b.y + 1 - bandStart ) );
+            bandView.fill( background );
+            render( bandView, PointI( area.a.x, bandStart ) );
+            for( uint32_t y=0; y<bandView.height(); ++y ) {
+                writer.writeRow( bandView.row( y ) );
+            }
+        }
+        writer.close();
+    }
+
+} /* namespace imgdraw2d */
@@ -23,14 +23,29 @@
 
 #include "imgdraw2d/Drawer2D.h"
 
+#include "imgdraw2d/ImagePool.h"
+#include "imgdraw2d/ImageCodec.h"
+
 
 namespace imgdraw2d {
 
+    static const std::size_t NO_REVISION = (std::size_t) -1;
+
+
     ImageBox::ImageBox(const double scale, const double margin):
             img(nullptr),
             sizeBox(),
+            origin(),
+            imageArea(),
+            croppedImg(nullptr),
             backgroundColor(0, 0, 0, 0),                             /// transparent color
             margin(margin),
+            growthFactor(1.0),
+            blank(true),
+            tiles(nullptr),
+            commands(nullptr),
+            bandHeight(DisplayList::DEFAULT_BAND_HEIGHT),
+            flattenRevision(NO_REVISION),
             scale(scale)
     {
         reset();
@@ -41,85 +56,268 @@ namespace imgdraw2d {
     }
 
     void ImageBox::reset() {
-        img.reset( new Image() );
+        img = ImagePool::global()->makeImage();
         sizeBox = RectD{ {0.0, 0.0}, {0.0, 0.0} };
+        origin = PointD{ 0.0, 0.0 };
+        imageArea = RectI();
+        croppedImg.reset();
+        blank = true;
+        flattenRevision = NO_REVISION;
+        if (tiles != nullptr) {
+            tiles->clear();
+        }
+        if (commands != nullptr) {
+            commands->clear();
+        }
+    }
+
+    void ImageBox::setTiled(const bool enabled, const uint32_t tileSize) {
+        commands.reset();
+        if (enabled) {
+            tiles.reset( new TiledImage( tileSize, backgroundColor ) );
+        } else {
+            tiles.reset();
+        }
+        reset();
+    }
+
+    void ImageBox::setStreaming(const bool enabled, const uint32_t bandHeight) {
+        tiles.reset();
+        if (enabled) {
+            commands.reset( new DisplayList() );
+        } else {
+            commands.reset();
+        }
+        this->bandHeight = bandHeight;
+        reset();
     }
 
     ImagePtr ImageBox::takeImage() {
+        crop();
         ImagePtr image;
         img.swap( image );
         reset();
         return image;
     }
 
+    void ImageBox::save(const std::string& path, const Image::SaveOptions& options) {
+        /// only PNG can be streamed, other formats are saved from flattened image
+        const bool streamed = (blank == false) && (ImageCodec::find( path ) == ImageCodec::png());
+        if (tiles != nullptr && streamed) {
+            tiles->save( path, canvasArea(), options );
+            return ;
+        }
+        if (commands != nullptr && streamed) {
+            commands->save( path, canvasArea(), backgroundColor, options, bandHeight );
+            return ;
+        }
+        visibleImage().save( path, options );
+    }
+
     PointI ImageBox::transformCoords(const double x, const double y) const {
+        const PointD position = gridPosition( x, y );
+        if (anchoredGrid() == false) {
+            /// grid is anchored to current area, so points inside it have non-negative position
+            const PointI pixelPoint{ (PointI::value_type) position.x, (PointI::value_type) position.y };
+            return pixelPoint - imageArea.a;
+        }
+        /// coordinates can be negative, so round down to keep pixels of equal size around origin
+        const PointI gridPoint{ (PointI::value_type) std::floor( position.x ), (PointI::value_type) std::floor( position.y ) };
+        if (virtualCanvas()) {
+            return gridPoint;
+        }
+        return gridPoint - imageArea.a;
+    }
+
+    PointD ImageBox::gridPosition(const double x, const double y) const {
         ///flip y coord
-        PointD relative{ x - sizeBox.a.x, sizeBox.b.y - y };
+        PointD relative{ x - origin.x, origin.y - y };
         relative.x += margin;
         relative.y += margin;
-        PointD scaled = relative * scale;
-        const PointI pixelPoint{ (PointI::value_type)scaled.x, (PointI::value_type)scaled.y };
-        return pixelPoint;
-
-//        ///flip y coord
-//        PointD relative{ x - sizeBox.a.x + margin, y - sizeBox.a.y + margin };
-//        PointD scaled = relative * scale;
-//        const uint32_t height = img->height();
-//        const PointI pixelPoint{ (PointI::value_type)scaled.x, height - (PointI::value_type)scaled.y };
-//        return pixelPoint;
+        return relative * scale;
     }
 
     void ImageBox::resize(const RectD& box) {
         sizeBox = box;
+        origin = PointD{ box.a.x, box.b.y };
+        blank = false;
+        if (virtualCanvas()) {
+            /// canvas origin is set by first area
+            if (tiles != nullptr)
+                tiles->clear();
+            if (commands != nullptr)
+                commands->clear();
+            flattenRevision = NO_REVISION;
+            return ;
+        }
+        imageArea = anchoredGrid() ? drawableArea() : canvasArea();
         resizeImage();
         img->fill( backgroundColor );
     }
 
     bool ImageBox::expand(const RectD& box) {
+        if (virtualCanvas()) {
+            if (blank) {
+                resize( box );
+                return false;
+            }
+            /// canvas does not need to be resized
+            if (sizeBox.expand( box )) {
+                flattenRevision = NO_REVISION;
+            }
+            return false;
+        }
+
         if (img->empty()) {
             resize( box );
             return false;
         }
 
+        if (anchoredGrid() == false) {
+            return expandArea( box );
+        }
+
+        const bool changed = sizeBox.expand( box );
+        if (changed == false) {
+            return false;
+        }
+        const RectI requested = drawableArea();
+        if (imageArea.contains( requested )) {
+            /// fits in reserved space
+            return false;
+        }
+
+        /// image is expanded by whole pixels, so grid does not move
+        const RectI oldArea = imageArea;
+        imageArea.expand( requested.a );
+        imageArea.expand( requested.b );
+        if (growthFactor > 1.0) {
+            /// reserve space in direction of expansion
+            const int64_t extraW = (growthFactor - 1.0) * ( imageArea.width() + 1 );
+            const int64_t extraH = (growthFactor - 1.0) * ( imageArea.height() + 1 );
+            if (requested.a.x < oldArea.a.x) imageArea.a.x -= extraW;
+            if (requested.b.x > oldArea.b.x) imageArea.b.x += extraW;
+            if (requested.a.y < oldArea.a.y) imageArea.a.y -= extraH;
+            if (requested.b.y > oldArea.b.y) imageArea.b.y += extraH;
+        }
+
+        replaceImage( oldArea.a - imageArea.a );
+        return true;
+    }
+
+    bool ImageBox::expandArea(const RectD& box) {
+        /// reserved space is not kept when grid moves with area
+        crop();
+
         const RectD oldBox = sizeBox;
         const bool changed = sizeBox.expand( box );
         if (changed == false) {
             return false;
         }
+        origin = PointD{ sizeBox.a.x, sizeBox.b.y };
+        imageArea = canvasArea();
+        const PointI from = transformCoords( oldBox.a.x - margin, oldBox.b.y + margin );
+        replaceImage( from );
+        return true;
+    }
+
+    void ImageBox::replaceImage(const PointI& from) {
         ImagePtr oldImg;
         oldImg.swap( img );
 
-        img.reset( new Image() );
+        img = ImagePool::global()->makeImage();
 
         resizeImage();
 
-        const double top = oldBox.a.x - margin;
-        const double left = oldBox.b.y + margin;
-        const Image* source = oldImg.get();
-
-        const PointI from = transformCoords(top, left);
-
         if ( backgroundColor != Image::TRANSPARENT ) {
-//            img->fill( backgroundColor );
             const PointI oldSize( oldImg->width(), oldImg->height() );
             PointI to = from + oldSize;
-            const uint32_t w = img->width();
-            const uint32_t h = img->height();
+            const int64_t w = img->width();
+            const int64_t h = img->height();
             if (to.x > w) to.x = w;
             if (to.y > h) to.y = h;
             const RectI gap( from, to );
             fillBackground( gap );
         }
 
-        img->pasteImage(from.x, from.y, *source);
-        return true;
+        img->pasteImage(from.x, from.y, *oldImg);
+    }
+
+    void ImageBox::crop() {
+        if (virtualCanvas()) {
+            flatten();
+            return ;
+        }
+        if (img->empty()) {
+            return ;
+        }
+        const RectI area = canvasArea();
+        if (area == imageArea)
+            return ;
+        const PointI from = area.a - imageArea.a;
+        img->crop( from.x, from.y, area.width() + 1, area.height() + 1 );
+        imageArea = area;
+    }
+
+    Image& ImageBox::visibleImage() const {
+        if (virtualCanvas()) {
+            flatten();
+            return *img;
+        }
+        const RectI area = canvasArea();
+        if (img->empty() || area == imageArea) {
+            return *img;
+        }
+        const PointI from = area.a - imageArea.a;
+        const std::size_t w = area.width() + 1;
+        const std::size_t h = area.height() + 1;
+        if (croppedImg == nullptr) {
+            croppedImg = ImagePool::global()->makeImage();
+        }
+        croppedImg->resize( w, h );
+        croppedImg->pasteImage( 0, 0, ConstImageView( *img, from.x, from.y, w, h ) );
+        return *croppedImg;
+    }
+
+    void ImageBox::flatten() const {
+        if (blank)
+            return ;
+        const std::size_t revision = (tiles != nullptr) ? tiles->revision() : commands->revision();
+        if (flattenRevision == revision)
+            return ;
+        const RectI area = canvasArea();
+        img->resize( area.width() + 1, area.height() + 1 );
+        const ImageView target( *img );
+        if (tiles != nullptr) {
+            tiles->flatten( target, area.a );
+        } else {
+            target.fill( backgroundColor );
+            commands->render( target, area.a );
+        }
+        flattenRevision = revision;
+    }
+
+    RectI ImageBox::canvasArea() const {
+        /// margin is added on both sides, so it cancels out, small tolerance prevents
+        /// adding pixel due to rounding error when area edge lies exactly on pixel border
+        const double tolerance = 1.0e-6;
+        const PointI from{ (PointI::value_type) std::floor( (sizeBox.a.x - origin.x) * scale + tolerance ),
+                           (PointI::value_type) std::floor( (origin.y - sizeBox.b.y) * scale + tolerance ) };
+        const int64_t w = scale * ( 2 * margin + sizeBox.width() );
+        const int64_t h = scale * ( 2 * margin + sizeBox.height() );
+        return RectI( from, from + PointI( w - 1, h - 1 ) );
+    }
+
+    RectI ImageBox::drawableArea() const {
+        RectI area = canvasArea();
+        const PointD border = gridPosition( sizeBox.b.x + margin, sizeBox.a.y - margin );
+        area.expand( PointI{ (PointI::value_type) std::floor( border.x ), (PointI::value_type) std::floor( border.y ) } );
+        return area;
     }
 
     void ImageBox::resizeImage() {
-        const double boxW = sizeBox.width();
-        const double boxH = sizeBox.height();
-        const std::size_t w = scale * ( 2 * margin + boxW );
-        const std::size_t h = scale * ( 2 * margin + boxH );
+        const std::size_t w = std::max( imageArea.width() + 1, (int64_t) 0 );
+        const std::size_t h = std::max( imageArea.height() + 1, (int64_t) 0 );
         img->resize(w, h);
     }
 
@@ -0,0 +1,96 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "EdgeTable.h"
+
+#include <algorithm>
+
+
+namespace imgdraw2d {
+
+    EdgeTable::EdgeTable(const std::vector<PointI>& polygon): edges() {
+        const std::size_t count = polygon.size();
+        edges.reserve( count );
+        for( std::size_t i=0; i<count; ++i ) {
+            PointI upper = polygon[ i ];
+            PointI lower = polygon[ (i + 1) % count ];
+            if (upper.y == lower.y)
+                continue;
+            if (upper.y > lower.y)
+                std::swap( upper, lower );
+            edges.push_back( Edge{ upper.y, lower.y, upper.x, lower.x - upper.x, lower.y - upper.y } );
+        }
+        std::stable_sort( edges.begin(), edges.end(), [](const Edge& first, const Edge& second) {
+            return first.minY < second.minY;
+        } );
+    }
+
+    void EdgeTable::scan(const RectI& area, const std::function<void(int64_t, int64_t, int64_t)>& operation) const {
+        if (edges.empty())
+            return ;
+
+        std::vector<ActiveEdge> active;
+        std::vector<int64_t> crossings;
+        std::size_t next = 0;
+        int64_t y = std::max( area.a.y, edges.front().minY );
+        while (y <= area.b.y) {
+            /// update active edges
+            while (next < edges.size() && edges[ next ].minY <= y) {
+                const Edge& edge = edges[ next ];
+                ++next;
+                if (edge.maxY <= y)
+                    continue;
+                const int64_t numerator = edge.startX * edge.dy + (y - edge.minY) * edge.dx;
+                active.push_back( ActiveEdge{ &edge, numerator } );
+            }
+            active.erase( std::remove_if( active.begin(), active.end(), [y](const ActiveEdge& item) {
+                return item.edge->maxY <= y;
+            } ), active.end() );
+
+            if (active.empty()) {
+                if (next >= edges.size())
+                    return ;
+                /// skip rows without edges
+                y = edges[ next ].minY;
+                continue ;
+            }
+
+            /// pixel is covered if it lies on the left edge or between edges
+            crossings.clear();
+            for( ActiveEdge& item: active ) {
+                crossings.push_back( ceilDiv( item.numerator, item.edge->dy ) );
+                item.numerator += item.edge->dx;
+            }
+            std::sort( crossings.begin(), crossings.end() );
+            for( std::size_t i=0; i + 1 < crossings.size(); i += 2 ) {
+                const int64_t startX = std::max( crossings[ i ], area.a.x );
+                const int64_t endX = std::min( crossings[ i + 1 ] - 1, area.b.x );
+                if (startX <= endX)
+                    operation( y, startX, endX );
+            }
+            ++y;
+        }
+    }
+
+} /* namespace imgdraw2d */
@@ -0,0 +1,79 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_SRC_EDGETABLE_H_
+#define IMGDRAW2D_SRC_EDGETABLE_H_
+
+#include "imgdraw2d/Geometry.h"
+
+#include <vector>
+#include <functional>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Scanline rasterizer of polygons based on active edge table.
+     *
+     * Pixel (x, y) is covered if point (x, y) lies inside polygon according to even-odd rule.
+     * Left and top edges are included, right and bottom edges are excluded, so adjacent
+     * polygons do not overlap and axis aligned rectangle [x1, x2) x [y1, y2) covers the same
+     * pixels as Painter::fillRect().
+     */
+    class EdgeTable {
+
+        struct Edge {
+            int64_t minY;               /// first row crossed by edge
+            int64_t maxY;               /// row after last row crossed by edge
+            int64_t startX;             /// "x" of upper end
+            int64_t dx;
+            int64_t dy;                 /// always positive
+        };
+
+        struct ActiveEdge {
+            const Edge* edge;
+            int64_t numerator;          /// "x" of edge in current row multiplied by "dy"
+        };
+
+        std::vector<Edge> edges;        /// sorted by "minY"
+
+
+    public:
+
+        /// polygon is closed implicitly, horizontal edges are skipped
+        EdgeTable(const std::vector<PointI>& polygon);
+
+        bool empty() const {
+            return edges.empty();
+        }
+
+        /// calls "operation( y, startX, endX )" for every span of covered pixels inside "area" (borders included),
+        /// spans are reported row by row from top to bottom
+        void scan(const RectI& area, const std::function<void(int64_t, int64_t, int64_t)>& operation) const;
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_SRC_EDGETABLE_H_ */
@@ -23,9 +23,21 @@
 
 #include "imgdraw2d/Image.h"
 
-#include <png++/types.hpp>
-#include <boost/filesystem.hpp>
-#include <boost/filesystem/fstream.hpp>
+#include "imgdraw2d/ImageView.h"
+#include "imgdraw2d/ImagePool.h"
+#include "imgdraw2d/ImageCodec.h"
+#include "PixelKernels.h"
+#include "PngWriter.h"
+#include "PngReader.h"
+#include "RawFormat.h"
+
+#include <cstring>
+#include <cerrno>
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 
 namespace imgdraw2d {
@@ -39,44 +51,199 @@ namespace imgdraw2d {
     const Image::Pixel Image::ORANGE      = Image::convertColor("orange");
 
 
-    Image::Image(const std::string& path): img() {
-        if (path.empty() == false)
-            img.read(path);
+    static_assert( sizeof(Image::Pixel) == 4, "unexpected pixel size" );
+
+
+    using kernels::packPixel;
+    using kernels::pixelWords;
+
+
+    /// "target" is file path or memory buffer
+    template <typename Target>
+    static void writePng(const Image& image, Target& target, const Image::SaveOptions& options) {
+        if (image.width() < 1 || image.height() < 1) {
+            PngWriter::writeEmpty( target, Image::TRANSPARENT, options );
+            return ;
+        }
+
+        std::vector<Image::Pixel> palette;
+        if (PngWriter::usesPalette( options.format ))
+            PngWriter::collectPalette( image, palette, options.format );
+
+        PngWriter writer( target, image.width(), image.height(), options, palette );
+        writer.writeImage( image, options.threads );
+        writer.close();
+    }
+
+    /// read exactly "size" bytes starting from "offset"
+    static bool readBlock(const int fd, void* data, std::size_t size, off_t offset) {
+        uint8_t* target = static_cast<uint8_t*>( data );
+        while (size > 0) {
+            const ssize_t done = ::pread( fd, target, size, offset );
+            if (done < 0 && errno == EINTR)
+                continue ;
+            if (done <= 0)
+                return false;
+            target += done;
+            offset += done;
+            size -= done;
+        }
+        return true;
+    }
+
+    /// write all given blocks, partial writes are continued
+    static bool writeBlocks(const int fd, struct iovec* blocks, int count) {
+        while (count > 0) {
+            ssize_t done = ::writev( fd, blocks, count );
+            if (done < 0 && errno == EINTR)
+                continue ;
+            if (done < 0)
+                return false;
+            while (count > 0 && (std::size_t) done >= blocks->iov_len) {
+                done -= blocks->iov_len;
+                ++blocks;
+                --count;
+            }
+            if (count > 0) {
+                blocks->iov_base = static_cast<uint8_t*>( blocks->iov_base ) + done;
+                blocks->iov_len -= done;
+            }
+        }
+        return true;
+    }
+
+
+    /// read whole file, throws std::runtime_error on failure
+    static void readFile(const std::string& path, std::vector<uint8_t>& data) {
+        const int fd = ::open( path.c_str(), O_RDONLY );
+        if (fd < 0) {
+            throw std::runtime_error( path + ": " + std::strerror( errno ) );
+        }
+        struct stat info;
+        bool done = ( ::fstat( fd, &info ) == 0 );
+        if (done) {
+            data.resize( info.st_size );
+            done = readBlock( fd, data.data(), data.size(), 0 );
+        }
+        ::close( fd );
+        if (done == false) {
+            throw std::runtime_error( path + ": unable to read file" );
+        }
+    }
+
+    static void writeFile(const std::string& path, std::vector<uint8_t>& data) {
+        const int fd = ::open( path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+        if (fd < 0) {
+            throw std::runtime_error( path + ": " + std::strerror( errno ) );
+        }
+        struct iovec block;
+        block.iov_base = data.data();
+        block.iov_len = data.size();
+        const bool done = writeBlocks( fd, &block, 1 );
+        const int error = errno;
+        if ( ::close( fd ) != 0 || done == false ) {
+            throw std::runtime_error( path + ": " + std::strerror( done ? errno : error ) );
+        }
+    }
+
+
+    Image::Image(const std::string& path): buffer(), imgWidth(0), imgHeight(0), imgStride(0) {
+        if (path.empty() == false) {
+            read( path );
+        }
+    }
+
+    Image::Image(const uint32_t width, const uint32_t height): buffer(), imgWidth(0), imgHeight(0), imgStride(0) {
+        resize( width, height );
+    }
+
+    Image::Image(const Image& image): buffer(), imgWidth(0), imgHeight(0), imgStride(0) {
+        *this = image;
+    }
+
+    Image::Image(Image&& image): buffer( std::move(image.buffer) ), imgWidth(image.imgWidth), imgHeight(image.imgHeight), imgStride(image.imgStride), pool( std::move(image.pool) )
+    {
+        image.imgWidth = 0;
+        image.imgHeight = 0;
+        image.imgStride = 0;
+    }
+
+    Image::~Image() {
+        replaceBuffer( PixelBuffer() );
+    }
+
+    Image& Image::operator=(const Image& image) {
+        if (this == &image)
+            return *this;
+        const std::size_t usedBytes = image.imgStride * image.imgHeight * sizeof(Pixel);
+        PixelBuffer copy = allocate( usedBytes );
+        if (usedBytes > 0)
+            std::memcpy( copy.data(), image.buffer.data(), usedBytes );
+        replaceBuffer( std::move(copy) );
+        imgWidth = image.imgWidth;
+        imgHeight = image.imgHeight;
+        imgStride = image.imgStride;
+        return *this;
     }
 
-    Image::Image(const uint32_t width, const uint32_t height): img(width, height) {
+    Image& Image::operator=(Image&& image) {
+        if (this == &image)
+            return *this;
+        replaceBuffer( std::move( image.buffer ) );
+        pool = std::move( image.pool );
+        imgWidth = image.imgWidth;
+        imgHeight = image.imgHeight;
+        imgStride = image.imgStride;
+        image.imgWidth = 0;
+        image.imgHeight = 0;
+        image.imgStride = 0;
+        return *this;
     }
 
     bool Image::equals(const Image& image) const {
         if (this == &image)
             return true;
-        return compare(image.img);
+        return compare(image);
+    }
+
+    uint64_t Image::hash() const {
+        /// multiply-xorshift over 64-bit words of each row
+        const uint64_t prime = 0x9E3779B97F4A7C15ULL;
+        uint64_t value = ( (uint64_t) imgWidth << 32 ) ^ imgHeight;
+        value *= prime;
+        const std::size_t words = imgWidth / 2;
+        for( uint32_t y = 0; y<imgHeight; ++y ) {
+            const uint8_t* rowBytes = reinterpret_cast<const uint8_t*>( row(y) );
+            for( std::size_t i = 0; i<words; ++i ) {
+                uint64_t word = 0;
+                std::memcpy( &word, rowBytes + i * sizeof(word), sizeof(word) );
+                value = ( value ^ word ) * prime;
+                value ^= value >> 29;
+            }
+            if ( imgWidth % 2 != 0 ) {
+                const uint64_t word = packPixel( row(y)[ imgWidth - 1 ] );
+                value = ( value ^ word ) * prime;
+                value ^= value >> 29;
+            }
+        }
+
+        return value;
     }
 
     bool Image::empty() const {
-        if ( img.get_width() != 0 )
+        if ( imgWidth != 0 )
             return false;
-        if ( img.get_height() != 0 )
+        if ( imgHeight != 0 )
             return false;
         return true;
     }
 
     uint32_t Image::width() const {
-        return img.get_width();
+        return imgWidth;
     }
 
     uint32_t Image::height() const {
-        return img.get_height();
-    }
-
-    Image::row_const_access Image::row(const std::size_t y) const {
-        const Image::RawImage::pixbuf& pixbuf = img.get_pixbuf();
-        return pixbuf[ y ];
-    }
-
-    Image::row_access Image::row(const std::size_t y) {
-        Image::RawImage::pixbuf& pixbuf = img.get_pixbuf();
-        return pixbuf[ y ];
+        return imgHeight;
     }
 
     const Image::Pixel& Image::pixel(const std::size_t x, const std::size_t y) const {
@@ -85,12 +252,12 @@ namespace imgdraw2d {
     }
 
     void Image::setPixel(const std::size_t x, const std::size_t y, const Pixel& color) {
-        img.set_pixel( x, y, color );
+        row(y)[x] = color;
     }
 
     void Image::setPixelColor(const std::size_t x, const std::size_t y, const std::string& color) {
         const Image::Pixel pixColor = convertColor(color);
-        img.set_pixel(x, y, pixColor);
+        row(y)[x] = pixColor;
     }
 
     void Image::fillTransparent() {
@@ -103,75 +270,145 @@ namespace imgdraw2d {
     }
 
     void Image::fill(const Pixel& color) {
-        const uint32_t w = width();
-        const uint32_t h = height();
-        for( uint32_t y = 0; y<h; ++y ) {
-            Image::row_access tgtRow = row(y);
-            for( uint32_t x = 0; x<w; ++x ) {
-                tgtRow[x] = color;
-            }
-        }
+        /// fill whole buffer at once (including rows padding)
+        kernels::fillPixels( pixelWords( data() ), imgStride * imgHeight, packPixel( color ) );
     }
 
     void Image::fillRect(const std::size_t sx, const std::size_t sy, const std::size_t ex, const std::size_t ey, const Pixel& color ) {
-        const std::size_t w = img.get_width();
-        const std::size_t h = img.get_height();
-        const std::size_t endW = std::min(w, ex );
-        const std::size_t endH = std::min(h, ey );
-        for( std::size_t j = sy; j<endH; ++j ) {
-            Image::row_access tgtRow = row(j);
-            for( std::size_t i = sx; i<endW; ++i ) {
-                tgtRow[i] = color;
-            }
-        }
+        ImageView( *this ).fillRect( sx, sy, ex, ey, color );
     }
 
     void Image::pasteImage(const std::size_t x, const std::size_t y, const Image& source ) {
-        const std::size_t w = img.get_width();
-        const std::size_t h = img.get_height();
-        const std::size_t endW = std::min(w, x + source.width() );
-        const std::size_t endH = std::min(h, y + source.height() );
-
-        for( std::size_t j = y; j<endH; ++j ) {
-            Image::row_const_access srcRow = source.row( j - y );
-            Image::row_access tgtRow = row(j);
-            for( std::size_t i = x; i<endW; ++i ) {
-                tgtRow[i] = srcRow[ i - x ];
-            }
+        const std::size_t endH = std::min( (std::size_t) imgHeight, y + source.height() );
+        if (x == 0 && source.width() >= imgWidth && imgStride == source.stride() && y < endH) {
+            /// rows are laid out in the same way -- copy whole block at once (including rows padding)
+            const std::size_t blockLength = (endH - y) * imgStride;
+            kernels::copyPixels( pixelWords( row(y) ), pixelWords( source.data() ), blockLength );
+            return ;
         }
+        pasteImage( x, y, ConstImageView( source ) );
+    }
+
+    void Image::pasteImage(const std::size_t x, const std::size_t y, const ConstImageView& source ) {
+        ImageView( *this ).pasteImage( x, y, source );
     }
 
     bool Image::load(const std::string& path) {
         try {
-            img.read(path);
+            read( path );
             return true;
-        } catch (const png::std_error& e) {
+        } catch (const std::runtime_error& e) {
             return false;
         }
-        return false;
     }
 
-    void Image::save(const std::string& path) {
-        {
-            boost::filesystem::path filePath( path );
-            boost::filesystem::path fileDir = filePath.parent_path();
-            if (fileDir.empty() == false)
-                boost::filesystem::create_directories(fileDir);
-            boost::filesystem::ofstream output( filePath );
+    void Image::save(const std::string& path, const SaveOptions& options) {
+        PngWriter::createParentDirectory( path );
+        const ImageCodecPtr codec = ImageCodec::find( path );
+        if (codec == ImageCodec::png()) {
+            /// rows are encoded directly to file
+            writePng( *this, path, options );
+            return ;
         }
+        std::vector<uint8_t> stream;
+        codec->encode( *this, stream, options );
+        writeFile( path, stream );
+    }
 
-        if (img.get_width() < 1 || img.get_height() < 1) {
-            RawImage tmp( (png::uint_32) 1, (png::uint_32) 1 );
-            tmp.write(path);
-            return ;
+    bool Image::decodePng(const void* data, const std::size_t size) {
+        try {
+            PngReader reader( data, size );
+            decode( reader );
+            return true;
+        } catch (const std::runtime_error& e) {
+            return false;
         }
+    }
+
+    void Image::encodePng(std::vector<uint8_t>& output, const SaveOptions& options) const {
+        output.clear();
+        writePng( *this, output, options );
+    }
+
+    bool Image::loadRaw(const std::string& path) {
+        const int fd = ::open( path.c_str(), O_RDONLY );
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        raw::Header header;
+        if ( ::fstat( fd, &info ) != 0 || readBlock( fd, &header, sizeof(header), 0 ) == false || raw::validHeader( header, info.st_size ) == false ) {
+            ::close( fd );
+            return false;
+        }
+
+        const std::size_t newStride = calculateStride( header.width );
+        const std::size_t rowBytes = newStride * sizeof(Pixel);
+        PixelBuffer newBuffer = allocate( rowBytes * header.height );
+        bool done = true;
+        if (header.stride == rowBytes) {
+            /// layout of rows is the same -- read whole buffer at once
+            done = readBlock( fd, newBuffer.data(), rowBytes * header.height, header.dataOffset );
+        } else {
+            const std::size_t usedBytes = header.width * sizeof(Pixel);
+            for( uint32_t y = 0; y<header.height && done; ++y ) {
+                done = readBlock( fd, newBuffer.data() + y * rowBytes, usedBytes, header.dataOffset + y * header.stride );
+            }
+        }
+        ::close( fd );
+        if (done == false)
+            return false;
+
+        replaceBuffer( std::move(newBuffer) );
+        imgWidth = header.width;
+        imgHeight = header.height;
+        imgStride = newStride;
+        return true;
+    }
+
+    void Image::saveRaw(const std::string& path) const {
+        PngWriter::createParentDirectory( path );
 
+        const int fd = ::open( path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+        if (fd < 0) {
+            throw std::runtime_error( path + ": " + std::strerror( errno ) );
+        }
 
-        img.write(path);
+        raw::Header header = raw::makeHeader( imgWidth, imgHeight, imgStride );
+        struct iovec blocks[2];
+        blocks[0].iov_base = &header;
+        blocks[0].iov_len = sizeof(header);
+        blocks[1].iov_base = const_cast<uint8_t*>( buffer.data() );
+        blocks[1].iov_len = imgStride * imgHeight * sizeof(Pixel);
+        const bool done = writeBlocks( fd, blocks, 2 );
+        const int error = errno;
+        if ( ::close( fd ) != 0 || done == false ) {
+            throw std::runtime_error( path + ": " + std::strerror( done ? errno : error ) );
+        }
     }
 
     void Image::resize(const std::size_t width, const std::size_t height) {
-        img.resize(width, height);
+        if (width == imgWidth && height == imgHeight)
+            return ;
+
+        const std::size_t newStride = calculateStride( width );
+        const std::size_t newSize = newStride * height * sizeof(Pixel);
+        PixelBuffer newBuffer = allocate( newSize );
+        if (newSize > 0)
+            std::memset( newBuffer.data(), 0, newSize );
+
+        /// copy common area
+        const std::size_t commonW = std::min( width, (std::size_t) imgWidth );
+        const std::size_t commonH = std::min( height, (std::size_t) imgHeight );
+        Pixel* newData = reinterpret_cast<Pixel*>( newBuffer.data() );
+        for( std::size_t y = 0; y<commonH; ++y ) {
+            std::memcpy( newData + y * newStride, row(y), commonW * sizeof(Pixel) );
+        }
+
+        replaceBuffer( std::move(newBuffer) );
+        imgWidth = width;
+        imgHeight = height;
+        imgStride = newStride;
     }
 
     Image::Pixel Image::convertColor(const std::string& color) {
@@ -223,27 +460,95 @@ namespace imgdraw2d {
         return Image::Pixel();
     }
 
-    bool Image::compare(const RawImage& image) const {
-        const png::uint_32 width = img.get_width();
-        if ( width != image.get_width() )
+    bool Image::compare(const Image& image) const {
+        if ( imgWidth != image.width() )
             return false;
-        const png::uint_32 height = img.get_height();
-        if ( height != image.get_height() )
+        if ( imgHeight != image.height() )
             return false;
+        /// cached hash is not used, pixels can be modified through views without invalidating it
+        return ConstImageView( *this ).equals( image );
+    }
+
+    void Image::read(const std::string& path) {
+        const ImageCodecPtr codec = ImageCodec::find( path );
+        if (codec == ImageCodec::png()) {
+            PngReader reader( path );
+            decode( reader );
+            return ;
+        }
+        std::vector<uint8_t> stream;
+        readFile( path, stream );
+        if (codec->decode( stream.data(), stream.size(), *this ) == false) {
+            throw std::runtime_error( path + ": invalid " + codec->name() + " file" );
+        }
+    }
 
-        /// compare pixels
-        for(png::uint_32 y=0; y<height; ++y) {
-            Image::row_const_access rowA = row( y );
-            Image::row_const_access rowB = image.get_row( y );
-            for(png::uint_32 x=0; x<width; ++x) {
-                const Pixel& pix = rowA[x];
-                const Pixel& other = rowB[x];
-                if (pix != other)
-                    return false;
+    void Image::decode(PngReader& reader) {
+        const uint32_t width = reader.width();
+        const uint32_t height = reader.height();
+        std::vector<png_bytep> rows( height );
+
+        /// stream can turn out to be corrupted while reading rows, so rows are decoded into
+        /// separate buffer (recycled by pool) and current buffer is replaced only on success
+        const std::size_t newStride = calculateStride( width );
+        PixelBuffer newBuffer = allocate( newStride * height * sizeof(Pixel) );
+        Pixel* newData = reinterpret_cast<Pixel*>( newBuffer.data() );
+        for( uint32_t y = 0; y<height; ++y ) {
+            rows[y] = reinterpret_cast<png_bytep>( newData + y * newStride );
+        }
+        reader.readImage( rows.data() );
+
+        replaceBuffer( std::move(newBuffer) );
+        imgWidth = width;
+        imgHeight = height;
+        imgStride = newStride;
+    }
+
+    void Image::crop(const std::size_t x, const std::size_t y, const std::size_t width, const std::size_t height) {
+        if (x >= imgWidth || y >= imgHeight) {
+            imgWidth = 0;
+            imgHeight = 0;
+                return ;
+        }
+        const std::size_t newWidth = std::min( (std::size_t) imgWidth - x, width );
+        const std::size_t newHeight = std::min( (std::size_t) imgHeight - y, height );
+        if (x > 0 || y > 0) {
+            /// source row is never before target row, so rows can be moved in ascending order
+            Pixel* pixels = data();
+            for( std::size_t j = 0; j<newHeight; ++j ) {
+                std::memmove( pixels + j * imgStride, pixels + (y + j) * imgStride + x, newWidth * sizeof(Pixel) );
             }
         }
+        imgWidth = newWidth;
+        imgHeight = newHeight;
+    }
 
-        return true;
+    void Image::setPool(const std::shared_ptr<ImagePool>& imagePool) {
+        pool = imagePool;
+    }
+
+    PixelBuffer Image::allocate(const std::size_t size) const {
+        std::shared_ptr<ImagePool> imagePool = pool.lock();
+        if (imagePool != nullptr)
+            return imagePool->acquire( size );
+        return PixelBuffer( size );
+    }
+
+    void Image::replaceBuffer(PixelBuffer&& newBuffer) {
+        PixelBuffer oldBuffer( std::move(newBuffer) );
+        buffer.swap( oldBuffer );
+        if (oldBuffer.empty())
+            return ;
+        std::shared_ptr<ImagePool> imagePool = pool.lock();
+        if (imagePool != nullptr)
+            imagePool->release( std::move(oldBuffer) );
+    }
+
+    std::size_t Image::calculateStride(const std::size_t width) {
+        const std::size_t rest = width % STRIDE_ALIGNMENT;
+        if (rest == 0)
+            return width;
+        return width + STRIDE_ALIGNMENT - rest;
     }
 
 } /* namespace imgdraw2d */
@@ -0,0 +1,137 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "imgdraw2d/ImageCache.h"
+
+#include <sys/stat.h>
+
+
+namespace imgdraw2d {
+
+    ImageCache::ImageCache(const std::size_t capacity): mutex(), entries(), index(), cachedBytes(0), capacity(capacity) {
+    }
+
+    std::shared_ptr<ImageCache> ImageCache::make(const std::size_t capacity) {
+        return std::shared_ptr<ImageCache>( new ImageCache(capacity) );
+    }
+
+    std::shared_ptr<ImageCache> ImageCache::global() {
+        static std::shared_ptr<ImageCache> cache = make();
+        return cache;
+    }
+
+    ImageCache::ImageConstPtr ImageCache::load(const std::string& path) {
+        FileStamp stamp;
+        if (fileStamp( path, stamp ) == false) {
+            remove( path );
+            return ImageConstPtr();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            auto found = index.find( path );
+            if (found != index.end()) {
+                EntryList::iterator entry = found->second;
+                if (entry->stamp == stamp) {
+                    entries.splice( entries.begin(), entries, entry );
+                    return entry->image;
+                }
+                erase( entry );
+            }
+        }
+
+        /// decode without lock, so other files can be loaded concurrently
+        std::shared_ptr<Image> image = std::make_shared<Image>();
+        if (image->load( path ) == false)
+            return ImageConstPtr();
+        const std::size_t bytes = image->stride() * image->height() * sizeof(Image::Pixel);
+
+        std::lock_guard<std::mutex> lock( mutex );
+        auto found = index.find( path );
+        if (found != index.end()) {
+            /// other thread loaded the same file in meantime
+            erase( found->second );
+        }
+        if (bytes > capacity)
+            return image;
+        entries.push_front( Entry{ path, stamp, image, bytes } );
+        index[ path ] = entries.begin();
+        cachedBytes += bytes;
+        shrink();
+        return image;
+    }
+
+    void ImageCache::remove(const std::string& path) {
+        std::lock_guard<std::mutex> lock( mutex );
+        auto found = index.find( path );
+        if (found != index.end()) {
+            erase( found->second );
+        }
+    }
+
+    void ImageCache::clear() {
+        std::lock_guard<std::mutex> lock( mutex );
+        entries.clear();
+        index.clear();
+        cachedBytes = 0;
+    }
+
+    void ImageCache::setCapacity(const std::size_t bytes) {
+        std::lock_guard<std::mutex> lock( mutex );
+        capacity = bytes;
+        shrink();
+    }
+
+    std::size_t ImageCache::size() const {
+        std::lock_guard<std::mutex> lock( mutex );
+        return cachedBytes;
+    }
+
+    std::size_t ImageCache::count() const {
+        std::lock_guard<std::mutex> lock( mutex );
+        return entries.size();
+    }
+
+    bool ImageCache::fileStamp(const std::string& path, FileStamp& stamp) {
+        struct stat info;
+        if (::stat( path.c_str(), &info ) != 0)
+            return false;
+        stamp.modified = (int64_t) info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+        stamp.size = info.st_size;
+        return true;
+    }
+
+    void ImageCache::shrink() {
+        while (cachedBytes > capacity && entries.empty() == false) {
+            erase( std::prev( entries.end() ) );
+        }
+    }
+
+    void ImageCache::erase(EntryList::iterator entry) {
+        cachedBytes -= entry->bytes;
+        index.erase( entry->path );
+        entries.erase( entry );
+    }
+
+} /* namespace imgdraw2d */
@@ -0,0 +1,128 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "imgdraw2d/ImageCodec.h"
+
+#include "QoiCodec.h"
+#include "PnmCodec.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include <map>
+#include <mutex>
+
+
+namespace imgdraw2d {
+
+    class PngCodec: public ImageCodec {
+    public:
+
+        std::string name() const override {
+            return "PNG";
+        }
+
+        bool decode(const void* data, const std::size_t size, Image& image) const override {
+            return image.decodePng( data, size );
+        }
+
+        void encode(const Image& image, std::vector<uint8_t>& output, const Image::SaveOptions& options) const override {
+            image.encodePng( output, options );
+        }
+
+    };
+
+
+    /// ===============================================================================
+
+
+    struct CodecRegistry {
+        std::mutex mutex;
+        std::map<std::string, ImageCodecPtr> codecs;          /// extension -> codec
+
+        CodecRegistry(): mutex(), codecs() {
+            codecs[ "png" ] = ImageCodec::png();
+            codecs[ "qoi" ] = ImageCodec::qoi();
+            codecs[ "ppm" ] = ImageCodec::ppm();
+            codecs[ "pgm" ] = ImageCodec::ppm();
+            codecs[ "pnm" ] = ImageCodec::ppm();
+            codecs[ "pam" ] = ImageCodec::pam();
+        }
+
+        static CodecRegistry& instance() {
+            static CodecRegistry registry;
+            return registry;
+        }
+    };
+
+
+    ImageCodecPtr ImageCodec::find(const std::string& path) {
+        std::string extension = boost::filesystem::path( path ).extension().string();
+        if (extension.empty())
+            return png();
+        extension = boost::algorithm::to_lower_copy( extension.substr( 1 ) );
+
+        CodecRegistry& registry = CodecRegistry::instance();
+        std::lock_guard<std::mutex> lock( registry.mutex );
+        auto found = registry.codecs.find( extension );
+        if (found == registry.codecs.end())
+            return png();
+        return found->second;
+    }
+
+    void ImageCodec::registerCodec(const std::string& extension, const ImageCodecPtr& codec) {
+        CodecRegistry& registry = CodecRegistry::instance();
+        std::lock_guard<std::mutex> lock( registry.mutex );
+        registry.codecs[ boost::algorithm::to_lower_copy( extension ) ] = codec;
+    }
+
+    ImageCodecPtr ImageCodec::png() {
+        static ImageCodecPtr codec = std::make_shared<PngCodec>();
+        return codec;
+    }
+
+    ImageCodecPtr ImageCodec::qoi() {
+        static ImageCodecPtr codec = std::make_shared<QoiCodec>();
+        return codec;
+    }
+
+    ImageCodecPtr ImageCodec::ppm() {
+        static ImageCodecPtr codec = std::make_shared<PnmCodec>( PnmCodec::PPM );
+        return codec;
+    }
+
+    ImageCodecPtr ImageCodec::pam() {
+        static ImageCodecPtr codec = std::make_shared<PnmCodec>( PnmCodec::PAM );
+        return codec;
+    }
+
+    void ImageCodec::prepare(Image& image, const uint32_t width, const uint32_t height) {
+        if (image.width() == width && image.height() == height)
+            return ;
+        /// release old buffer first, so its content is not copied
+        image.resize( 0, 0 );
+        image.resize( width, height );
+    }
+
+} /* namespace imgdraw2d */
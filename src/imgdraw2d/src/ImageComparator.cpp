@@ -24,6 +24,8 @@
 #include "imgdraw2d/ImageComparator.h"
 
 #include "imgdraw2d/Painter.h"
+#include "imgdraw2d/ImagePool.h"
+#include "imgdraw2d/ImageCache.h"
 
 
 //static QImage::Format DIFF_IMG_FORMAT = QImage::Format_RGB32;
@@ -35,7 +37,7 @@ static const int DIFF_IMAGES_SPACING = CHESS_GRID_SIZE * 2;
 namespace imgdraw2d {
 
     static ImagePtr generateChessboard(const uint32_t width, const uint32_t height) {
-        ImagePtr chessPtr( new Image(width, height) );
+        ImagePtr chessPtr = ImagePool::global()->makeImage(width, height);
         Image& chess = *chessPtr;
         chess.fill( "#666666" );
         Painter painter(&chess);
@@ -58,18 +60,24 @@ namespace imgdraw2d {
         return chessPtr;
     }
 
-    inline bool isDifferent(const Image& imageA, const Image& imageB, const uint32_t x, const uint32_t y) {
-        if (x >= imageA.width()) return true;
-        if (x >= imageB.width()) return true;
-        if (y >= imageA.height()) return true;
-        if (y >= imageB.height()) return true;
-
-        const Image::Pixel& pixA = imageA.pixel(x, y);
-        const Image::Pixel& pixB = imageB.pixel(x, y);
-        return (pixA != pixB);
+    /// draws white pixel where images differ and black where pixels are the same
+    static void drawThreshold(const ImageView& threshold, const ConstImageView& imageA, const ConstImageView& imageB) {
+        const uint32_t commonW = std::min( imageA.width(), imageB.width() );
+        const uint32_t commonH = std::min( imageA.height(), imageB.height() );
+        threshold.fill( Image::WHITE );                         /// area out of any image is different
+        for (uint32_t ho=0; ho<commonH; ++ho) {
+            Image::row_access tgtRow = threshold.row(ho);
+            Image::row_const_access rowA = imageA.row(ho);
+            Image::row_const_access rowB = imageB.row(ho);
+            for (uint32_t wo=0; wo<commonW; ++wo) {
+                if ( rowA[ wo ] == rowB[ wo ] ) {
+                    tgtRow[ wo ] = Image::BLACK;
+                }
+            }
+        }
     }
 
-    ImagePtr ImageComparator::compare(const Image& imgA, const Image& imgB) {
+    ImagePtr ImageComparator::compare(const ConstImageView& imgA, const ConstImageView& imgB) {
         if(imgA.empty() && imgB.empty()) {
             ImagePtr emptyDiff( new Image(2, 1) );
             Image& empty = *emptyDiff;
@@ -86,31 +94,6 @@ namespace imgdraw2d {
         const uint32_t widthMax = std::max(widthA, widthB);
         const uint32_t heightMax = std::max(heightA, heightB);
 
-        ImagePtr diffPtr( new Image(widthMax, heightMax) );
-        Image& diff = *diffPtr;
-        diff.fillTransparent();
-        {
-            Painter painter(&diff);
-            painter.setCompositionMode( Painter::CM_DIFFERENCE );
-            painter.drawImage(0, 0, imgA);
-            painter.drawImage(0, 0, imgB);
-        }
-
-        ImagePtr thresholdPtr( new Image(widthMax, heightMax) );
-        Image& threshold = *thresholdPtr;
-        threshold.fillTransparent();
-        for (uint32_t ho=0; ho<heightMax; ++ho) {
-            Image::row_access tgtRow = thresholdPtr->row(ho);
-            for (uint32_t wo=0; wo<widthMax; ++wo) {
-                //TODO: optimize -- replace isDifferent with direct access to pixbuf
-                if ( isDifferent(imgA, imgB, wo, ho) ) {
-                    tgtRow[ wo ] = Image::WHITE;
-                } else {
-                    tgtRow[ wo ] = Image::BLACK;
-                }
-            }
-        }
-
         ImagePtr joinPtr = generateChessboard(widthMax*2 + DIFF_IMAGES_SPACING, heightMax*2 + DIFF_IMAGES_SPACING);
         Image& join = *joinPtr;
         {
@@ -121,8 +104,19 @@ namespace imgdraw2d {
             if (imgB.empty() == false) {
                 painter.drawImage(widthMax + DIFF_IMAGES_SPACING, 0, imgB);
             }
-            painter.drawImage(0, heightMax + DIFF_IMAGES_SPACING, threshold);
-            painter.drawImage(widthMax + DIFF_IMAGES_SPACING, heightMax + DIFF_IMAGES_SPACING, diff);
+        }
+
+        /// subimages are drawn directly on result image
+        const ImageView threshold( join, 0, heightMax + DIFF_IMAGES_SPACING, widthMax, heightMax );
+        drawThreshold( threshold, imgA, imgB );
+
+        const ImageView diff( join, widthMax + DIFF_IMAGES_SPACING, heightMax + DIFF_IMAGES_SPACING, widthMax, heightMax );
+        diff.fill( Image::TRANSPARENT );
+        {
+            Painter painter(diff);
+            painter.setCompositionMode( Painter::CM_DIFFERENCE );
+            painter.drawImage(0, 0, imgA);
+            painter.drawImage(0, 0, imgB);
         }
 
         return joinPtr;
@@ -135,19 +129,30 @@ namespace imgdraw2d {
         return compare( *imgA, *imgB );
     }
 
-    bool ImageComparator::compare(const Image& imgA, const Image& imgB, const std::string& diffImage) {
+    bool ImageComparator::compare(const ConstImageView& imgA, const ConstImageView& imgB, const std::string& diffImage) {
+        if (imgA.equals(imgB)) {
+            return true;
+        }
         ImagePtr diff = compare(imgA, imgB);
-        if (imgA != imgB) {
-            diff->save( diffImage );
-            return false;
+        diff->save( diffImage );
+        return false;
+    }
+
+    bool ImageComparator::compare(const Image& imgA, const Image& imgB, const std::string& diffImage) {
+        if (imgA == imgB) {
+            return true;
         }
-        return true;
+        ImagePtr diff = compare(imgA, imgB);
+        diff->save( diffImage );
+        return false;
     }
 
     bool ImageComparator::compare(const Image& imgA, const std::string& imgB, const std::string& diffImage) {
-        Image imageB;
-        imageB.load( imgB );
-        return compare( imgA, imageB, diffImage );
+        /// reference images are compared many times, so decoded ones are cached
+        const ImageCache::ImageConstPtr imageB = ImageCache::global()->load( imgB );
+        if (imageB == nullptr)
+            return compare( imgA, Image(), diffImage );
+        return compare( imgA, *imageB, diffImage );
     }
 
 }
@@ -0,0 +1,134 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "imgdraw2d/ImagePool.h"
+
+
+namespace imgdraw2d {
+
+    /// smallest size class, smaller buffers are not worth caching in separate classes
+    static const std::size_t MIN_SIZE_CLASS = 4096;
+
+
+    ImagePool::ImagePool(const std::size_t capacity): mutex(), buffers(), cachedBytes(0), capacity(capacity) {
+    }
+
+    std::shared_ptr<ImagePool> ImagePool::make(const std::size_t capacity) {
+        return std::shared_ptr<ImagePool>( new ImagePool(capacity) );
+    }
+
+    std::shared_ptr<ImagePool> ImagePool::global() {
+        static std::shared_ptr<ImagePool> pool = make();
+        return pool;
+    }
+
+    ImagePtr ImagePool::makeImage() {
+        ImagePtr image( new Image() );
+        image->setPool( shared_from_this() );
+        return image;
+    }
+
+    ImagePtr ImagePool::makeImage(const uint32_t width, const uint32_t height) {
+        ImagePtr image = makeImage();
+        image->resize( width, height );
+        return image;
+    }
+
+    PixelBuffer ImagePool::acquire(const std::size_t size) {
+        if (size == 0)
+            return PixelBuffer();
+        const std::size_t bufferSize = sizeClass( size );
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            auto found = buffers.find( bufferSize );
+            if (found != buffers.end() && found->second.empty() == false) {
+                std::vector<PixelBuffer>& list = found->second;
+                PixelBuffer buffer( std::move( list.back() ) );
+                list.pop_back();
+                if (list.empty()) {
+                    buffers.erase( found );
+                }
+                cachedBytes -= buffer.size();
+                return buffer;
+            }
+        }
+        return PixelBuffer( bufferSize );
+    }
+
+    void ImagePool::release(PixelBuffer&& buffer) {
+        PixelBuffer item( std::move(buffer) );
+        const std::size_t bufferSize = item.size();
+        if (bufferSize == 0)
+            return ;
+        if (bufferSize != sizeClass( bufferSize ))
+            return ;                                    /// buffer not created by pool
+        if (bufferSize > capacity)
+            return ;
+        std::lock_guard<std::mutex> lock( mutex );
+        buffers[ bufferSize ].push_back( std::move(item) );
+        cachedBytes += bufferSize;
+        shrink();
+    }
+
+    void ImagePool::clear() {
+        std::lock_guard<std::mutex> lock( mutex );
+        buffers.clear();
+        cachedBytes = 0;
+    }
+
+    void ImagePool::setCapacity(const std::size_t bytes) {
+        std::lock_guard<std::mutex> lock( mutex );
+        capacity = bytes;
+        shrink();
+    }
+
+    std::size_t ImagePool::size() const {
+        std::lock_guard<std::mutex> lock( mutex );
+        return cachedBytes;
+    }
+
+    std::size_t ImagePool::sizeClass(const std::size_t size) {
+        if (size <= MIN_SIZE_CLASS)
+            return MIN_SIZE_CLASS;
+        std::size_t power = MIN_SIZE_CLASS;
+        while (power * 2 <= size) {
+            power *= 2;
+        }
+        const std::size_t step = power / 4;
+        return ( (size + step - 1) / step ) * step;
+    }
+
+    void ImagePool::shrink() {
+        while (cachedBytes > capacity) {
+            auto biggest = buffers.rbegin();
+            std::vector<PixelBuffer>& list = biggest->second;
+            cachedBytes -= list.back().size();
+            list.pop_back();
+            if (list.empty()) {
+                buffers.erase( biggest->first );
+            }
+        }
+    }
+
+} /* namespace imgdraw2d */
@@ -0,0 +1,95 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "imgdraw2d/ImageView.h"
+
+#include "PixelKernels.h"
+
+
+namespace imgdraw2d {
+
+    using kernels::packPixel;
+    using kernels::pixelWords;
+
+
+    bool ConstImageView::equals(const ConstImageView& view) const {
+        if ( viewWidth != view.width() )
+            return false;
+        if ( viewHeight != view.height() )
+            return false;
+        if ( viewHeight == 0 )
+            return true;
+
+        if ( viewStride == viewWidth && view.stride() == viewWidth ) {
+            /// no gaps between rows -- compare whole blocks at once
+            const std::size_t bytes = (std::size_t) viewWidth * viewHeight * sizeof(Pixel);
+            return ( std::memcmp( origin, view.data(), bytes ) == 0 );
+        }
+
+        /// compare rows, stop on first difference
+        const std::size_t rowBytes = viewWidth * sizeof(Pixel);
+        for(uint32_t y=0; y<viewHeight; ++y) {
+            if ( std::memcmp( row( y ), view.row( y ), rowBytes ) != 0 )
+                return false;
+        }
+        return true;
+    }
+
+
+    /// =============================================================================
+
+
+    void ImageView::fill(const Pixel& color) const {
+        fillRect( 0, 0, viewWidth, viewHeight, color );
+    }
+
+    void ImageView::fillRect(const std::size_t sx, const std::size_t sy, const std::size_t ex, const std::size_t ey, const Pixel& color ) const {
+        const std::size_t endW = std::min( (std::size_t) viewWidth, ex );
+        const std::size_t endH = std::min( (std::size_t) viewHeight, ey );
+        if (sx >= endW || sy >= endH)
+            return ;
+        const uint32_t value = packPixel( color );
+        const std::size_t rowLength = endW - sx;
+        if (rowLength == viewStride) {
+            /// no gaps between rows
+            kernels::fillPixels( pixelWords( row(sy) ), rowLength * (endH - sy), value );
+            return ;
+        }
+        for( std::size_t j = sy; j<endH; ++j ) {
+            kernels::fillPixels( pixelWords( row(j) + sx ), rowLength, value );
+        }
+    }
+
+    void ImageView::pasteImage(const std::size_t x, const std::size_t y, const ConstImageView& source ) const {
+        const std::size_t endW = std::min( (std::size_t) viewWidth, x + source.width() );
+        const std::size_t endH = std::min( (std::size_t) viewHeight, y + source.height() );
+        if (x >= endW || y >= endH)
+            return ;
+        const std::size_t rowLength = endW - x;
+        for( std::size_t j = y; j<endH; ++j ) {
+            kernels::copyPixels( pixelWords( row(j) + x ), pixelWords( source.row( j - y ) ), rowLength );
+        }
+    }
+
+} /* namespace imgdraw2d */
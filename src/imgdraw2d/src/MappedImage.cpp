@@ -0,0 +1,104 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "imgdraw2d/MappedImage.h"
+
+#include "RawFormat.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+namespace imgdraw2d {
+
+    MappedImage::MappedImage(): mapping(nullptr), mappingSize(0), pixels() {
+    }
+
+    MappedImage::MappedImage(const std::string& path): MappedImage() {
+        open( path );
+    }
+
+    MappedImage::MappedImage(MappedImage&& image): mapping(image.mapping), mappingSize(image.mappingSize), pixels(image.pixels) {
+        image.mapping = nullptr;
+        image.mappingSize = 0;
+        image.pixels = ConstImageView();
+    }
+
+    MappedImage::~MappedImage() {
+        close();
+    }
+
+    MappedImage& MappedImage::operator=(MappedImage&& image) {
+        if (&image == this)
+            return *this;
+        close();
+        std::swap( mapping, image.mapping );
+        std::swap( mappingSize, image.mappingSize );
+        std::swap( pixels, image.pixels );
+        return *this;
+    }
+
+    bool MappedImage::open(const std::string& path) {
+        close();
+
+        const int fd = ::open( path.c_str(), O_RDONLY );
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        if (::fstat( fd, &info ) != 0 || (std::size_t) info.st_size < sizeof(raw::Header)) {
+            ::close( fd );
+            return false;
+        }
+
+        const std::size_t fileSize = info.st_size;
+        void* data = ::mmap( nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+        ::close( fd );                                              /// mapping keeps reference to file
+        if (data == MAP_FAILED)
+            return false;
+
+        const raw::Header* header = static_cast<const raw::Header*>( data );
+        if (raw::validHeader( *header, fileSize ) == false) {
+            ::munmap( data, fileSize );
+            return false;
+        }
+
+        mapping = data;
+        mappingSize = fileSize;
+        const uint8_t* rows = static_cast<const uint8_t*>( data ) + header->dataOffset;
+        pixels = ConstImageView( reinterpret_cast<const Image::Pixel*>( rows ), header->width, header->height, header->stride / sizeof(Image::Pixel) );
+        return true;
+    }
+
+    void MappedImage::close() {
+        if (mapping != nullptr) {
+            ::munmap( mapping, mappingSize );
+        }
+        mapping = nullptr;
+        mappingSize = 0;
+        pixels = ConstImageView();
+    }
+
+} /* namespace imgdraw2d */
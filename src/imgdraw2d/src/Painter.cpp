@@ -23,7 +23,12 @@
 
 #include "imgdraw2d/Painter.h"
 
+#include "imgdraw2d/DisplayList.h"
+
+#include "EdgeTable.h"
+
 #include <cmath>
+#include <initializer_list>
 
 
 namespace imgdraw2d {
@@ -57,6 +62,16 @@ namespace imgdraw2d {
         return value - subtractor;
     }
 
+    /// largest integer which square is not greater than "value"
+    inline int64_t isqrt(const int64_t value) {
+        int64_t root = (int64_t) std::sqrt( (double) value );
+        while (root > 0 && root * root > value)
+            --root;
+        while ((root + 1) * (root + 1) <= value)
+            ++root;
+        return root;
+    }
+
 
     /// ======================================================================================
 
@@ -67,113 +82,132 @@ namespace imgdraw2d {
         DestinationModeWorker(Image* image): ModeWorker(image) {
         }
 
-        void drawImage(const PointI& point, const Image& source) override {
-            img->pasteImage(point.x, point.y, source);
+        void drawImage(const PointI& point, const ConstImageView& source) override {
+            ImageView canvas = target();
+            const int64_t skipX = udiff( 0, point.x );
+            const int64_t skipY = udiff( 0, point.y );
+            const ConstImageView visible = source.region( skipX, skipY, source.width(), source.height() );
+            if (point.x + skipX >= canvas.width() || point.y + skipY >= canvas.height() || visible.width() < 1 || visible.height() < 1)
+                return ;
+            canvas.pasteImage( point.x + skipX, point.y + skipY, visible );
+            markChanged();
         }
 
         void drawLine(const PointI& fromPoint, const PointI& toPoint, const uint32_t width, const Image::Pixel& pixColor) override {
             const PointI lineVector = toPoint - fromPoint;
-            const PointI orthoVector = lineVector.ortho();
-            const RayI orthoRay( orthoVector );
 
             const uint32_t radius = std::max( width / 2, (uint32_t) 1 );
             RectI box = RectI::minmax(fromPoint, toPoint);
             box.expand( radius );
 
-            const int64_t w = img->width();
-            const int64_t h = img->height();
+            ImageView canvas = target();
+            const int64_t w = canvas.width();
+            const int64_t h = canvas.height();
+            if (w < 1 || h < 1)
+                return ;
             const PointI imgSize(w-1, h-1);
             box.trim( imgSize );
 
-            const Linear parallelLine = Linear::createFromParallel(lineVector);
+            if (width <= 2 && (lineVector.x != 0 || lineVector.y != 0)) {
+                drawThinLine( canvas, fromPoint, lineVector, box, pixColor );
+                return ;
+            }
 
+            /// span of each row is calculated from the same conditions as in LineCondition:
+            ///     -s < lineVector * currVector < |lineVector|^2 + s     (between ends of line)
+            ///     |lineVector x currVector| < radius * |lineVector|     (distance from line)
+            /// where "s" is scale of orthogonal ray's side
+            const double dx = lineVector.x;
+            const double dy = lineVector.y;
+            const double lengthSquare = dx * dx + dy * dy;
+            const double sideScale = (lineVector.y != 0) ? std::abs( dy ) : std::abs( dx );
+            const double maxCross = radius * std::sqrt( lengthSquare );
+
+            LineCondition condition( fromPoint, lineVector, radius );
             for( int64_t j=box.a.y; j<=box.b.y; ++j ) {
-                Image::row_access tgtRow = img->row( j );
-                for( int64_t i=box.a.x; i<=box.b.x; ++i ) {
-                    const PointI currVector = PointI{i, j} - fromPoint;
-                    const int64_t side1 = orthoRay.side( currVector );
-                    if (side1 < 0) {
-                        continue;
-                    }
-                    const PointI toVector = currVector - lineVector;
-                    const int64_t side2 = orthoRay.side( toVector );
-                    if (side2 > 0) {
-                        continue;
-                    }
-                    const double dist = parallelLine.distance( currVector );
-                    if (dist >= radius) {
-                        continue;
-                    }
-                    tgtRow[ i ] = pixColor;
+                const double vy = j - fromPoint.y;
+                double startX = box.a.x;
+                double endX = box.b.x;
+                if (lineVector.x != 0) {
+                    double limitA = ( -sideScale - dy * vy ) / dx;
+                    double limitB = ( lengthSquare + sideScale - dy * vy ) / dx;
+                    if (limitA > limitB)
+                        std::swap( limitA, limitB );
+                    startX = std::max( startX, fromPoint.x + limitA );
+                    endX = std::min( endX, fromPoint.x + limitB );
                 }
+                if (lineVector.y != 0) {
+                    double limitA = ( dx * vy - maxCross ) / dy;
+                    double limitB = ( dx * vy + maxCross ) / dy;
+                    if (limitA > limitB)
+                        std::swap( limitA, limitB );
+                    startX = std::max( startX, fromPoint.x + limitA );
+                    endX = std::min( endX, fromPoint.x + limitB );
+                }
+                fillSpan( canvas, j, std::floor( startX ), std::ceil( endX ), box.a.x, box.b.x, pixColor, condition );
             }
         }
 
         void fillRect(const PointI& point, const uint32_t width, const uint32_t height, const Image::Pixel& pixColor) override {
-            assert( point.x >= 0 );
-            assert( point.y >= 0 );
-            img->fillRect( point.x, point.y, point.x + width, point.y + height, pixColor );
+            const int64_t endX = point.x + width;
+            const int64_t endY = point.y + height;
+            if (endX <= 0 || endY <= 0)
+                return ;
+            const int64_t startX = std::max( point.x, (int64_t) 0 );
+            const int64_t startY = std::max( point.y, (int64_t) 0 );
+            ImageView canvas = target();
+            if (startX >= endX || startY >= endY || startX >= canvas.width() || startY >= canvas.height())
+                return ;
+            canvas.fillRect( startX, startY, endX, endY, pixColor );
+            markChanged( pixColor );
         }
 
         void fillRect(const PointI& topLeft, const PointI& topRight, const PointI& bottomRight, const PointI& bottomLeft, const Image::Pixel& pixColor) override {
-            const Linear line1 = Linear::createFromPoints( topLeft, topRight );
-            const Linear line2 = Linear::createFromPoints( topRight, bottomRight );
-            const Linear line3 = Linear::createFromPoints( bottomRight, bottomLeft );
-            const Linear line4 = Linear::createFromPoints( bottomLeft, topLeft );
+            QuadCondition condition( topLeft, topRight, bottomRight, bottomLeft );
 
             RectI bbox = RectI::minmax(topLeft, topRight);
             bbox.expand(bottomRight);
             bbox.expand(bottomLeft);
 
+            ImageView canvas = target();
+            const int64_t w = canvas.width();
+            const int64_t h = canvas.height();
+            if (w < 1 || h < 1)
+                return ;
+            if (bbox.b.x < 0 || bbox.b.y < 0 || bbox.a.x >= w || bbox.a.y >= h)
+                return ;
+            bbox.trim( PointI(w-1, h-1) );
+
+            /// span of each row is intersection of spans of edges
             for( int64_t j = bbox.a.y; j<=bbox.b.y; ++j ) {
-                Image::row_access tgtRow = img->row( j );
-                for( int64_t i = bbox.a.x; i<=bbox.b.x; ++i ) {
-                    if (line1.pointSide( i, j ) < 0) continue;
-                    if (line2.pointSide( i, j ) < 0) continue;
-                    if (line3.pointSide( i, j ) < 0) continue;
-                    if (line4.pointSide( i, j ) < 0) continue;
-                    tgtRow[ i ] = pixColor;
-                }
+                int64_t startX = bbox.a.x;
+                int64_t endX = bbox.b.x;
+                if (condition.clipRow( j, startX, endX ) == false)
+                    continue;
+                canvas.fillRect( startX, j, endX + 1, j + 1, pixColor );
+                markChanged( pixColor );
             }
         }
 
-        RectI getBBoxOnCircle(const PointI& center, const uint32_t radius) {
-            const int64_t w = img->width();
-            const int64_t h = img->height();
-            const int64_t startW = udiff( center.x, radius );
-            const int64_t startH = udiff( center.y, radius );
-            const int64_t endW = std::min( w-1, center.x + radius );
-            const int64_t endH = std::min( h-1, center.y + radius );
-            return RectI( PointI(startW, startH), PointI(endW, endH) );
-        }
-
-        RectI getBBoxInCircle(const PointI& center, const uint32_t radius) {
-            const uint32_t squareWidth = std::sqrt( 2 ) * radius;
-            const uint32_t side = squareWidth / 2;
-            const int64_t w = img->width();
-            const int64_t h = img->height();
-            const int64_t startW = udiff( center.x, side );
-            const int64_t startH = udiff( center.y, side );
-            const int64_t endW = std::min( w-1, center.x + side );
-            const int64_t endH = std::min( h-1, center.y + side );
-            return RectI( PointI(startW, startH), PointI(endW, endH) );
+        void fillPolygon(const std::vector<PointI>& polygon, const Image::Pixel& pixColor) override {
+            ImageView canvas = target();
+            const int64_t w = canvas.width();
+            const int64_t h = canvas.height();
+            if (w < 1 || h < 1)
+                return ;
+            const EdgeTable table( polygon );
+            table.scan( RectI( 0, 0, w-1, h-1 ), [&](const int64_t y, const int64_t startX, const int64_t endX) {
+                canvas.fillRect( startX, y, endX + 1, y + 1, pixColor );
+                markChanged( pixColor );
+            } );
         }
 
         void fillCircle(const PointI& center, const uint32_t radius, const Image::Pixel& pixColor) override {
-            const int64_t w = img->width();
-            const int64_t h = img->height();
-            const PointI imgSize(w-1, h-1);
-            RectI outerBox = getBBoxOnCircle( center, radius );
-            RectI innerBox = getBBoxInCircle( center, radius );
-            outerBox.trim( imgSize );
-            innerBox.trim( imgSize );
-
-            /// fill edges
-            CircleCondition circle( radius );
-            drawCircleEdges(center, outerBox, innerBox, pixColor, circle );
-
-            /// fill inner square
-            img->fillRect( innerBox.a.x, innerBox.a.y, innerBox.b.x, innerBox.b.y, pixColor );
+            ImageView canvas = target();
+            scanRing( canvas, center, 0, radius, [&](const int64_t /*diffY*/, const int64_t y, const int64_t startX, const int64_t endX) {
+                canvas.fillRect( center.x + startX, y, center.x + endX + 1, y + 1, pixColor );
+                markChanged( pixColor );
+            } );
         }
 
         void drawRing(const PointI& center, const uint32_t radius, const uint32_t width, const Image::Pixel& pixColor) override {
@@ -184,14 +218,11 @@ namespace imgdraw2d {
                 return ;
             }
 
-            const RectI outerBox  = getBBoxOnCircle( center, maxRadius );
-            const RectI middleBox = getBBoxInCircle( center, maxRadius );
-            const RectI innerBox  = getBBoxInCircle( center, minRadius );
-
-            /// fill edges
-            RingCondition circle( minRadius, maxRadius );
-            drawCircleEdges(center, outerBox, middleBox, pixColor, circle );
-            drawRectEdges(center, middleBox, innerBox, pixColor, circle );
+            ImageView canvas = target();
+            scanRing( canvas, center, minRadius, maxRadius, [&](const int64_t /*diffY*/, const int64_t y, const int64_t startX, const int64_t endX) {
+                canvas.fillRect( center.x + startX, y, center.x + endX + 1, y + 1, pixColor );
+                markChanged( pixColor );
+            } );
         }
 
         void drawArc(const PointI& center, const uint32_t radius, const uint32_t width, const double startAngle, const double range, const Image::Pixel& pixColor) override {
@@ -216,190 +247,298 @@ namespace imgdraw2d {
             const RayI fromRay( fromVector );
             const RayI toRay( toVector );
 
-            const RectI outerBox  = getBBoxOnCircle( center, maxRadius );
-            const RectI middleBox = getBBoxInCircle( center, maxRadius );
-            const RectI innerBox  = getBBoxInCircle( center, minRadius );
-
-            /// fill edges
-            ArcCondition circle( minRadius, maxRadius, fromRay, toRay, sum );
-            drawCircleEdges(center, outerBox, middleBox, pixColor, circle );
-            drawRectEdges(center, middleBox, innerBox, pixColor, circle );
+            ImageView canvas = target();
+            auto fill = [&](const int64_t y, const int64_t startX, const int64_t endX) {
+                if (startX > endX)
+                    return ;
+                canvas.fillRect( center.x + startX, y, center.x + endX + 1, y + 1, pixColor );
+                markChanged( pixColor );
+            };
+            scanRing( canvas, center, minRadius, maxRadius, [&](const int64_t diffY, const int64_t y, int64_t startX, int64_t endX) {
+                if (sum) {
+                    /// pixels on right side of "from" ray and on left side of "to" ray are skipped
+                    int64_t skipStart = startX;
+                    int64_t skipEnd = endX;
+                    clipRaySide( fromRay, diffY, false, skipStart, skipEnd );
+                    clipRaySide( toRay, diffY, true, skipStart, skipEnd );
+                    if (skipStart > skipEnd) {
+                        fill( y, startX, endX );
+                    } else {
+                        fill( y, startX, skipStart - 1 );
+                        fill( y, skipEnd + 1, endX );
+                    }
+                } else {
+                    /// pixels have to lie on left side of "from" ray and on right side of "to" ray
+                    clipRaySide( fromRay, diffY, true, startX, endX );
+                    clipRaySide( toRay, diffY, false, startX, endX );
+                    fill( y, startX, endX );
+                }
+            } );
         }
 
 
         /// ===================================================================================
 
 
-        struct CircleCondition {
-            uint32_t rSquare;
-
-            CircleCondition(const uint32_t radius): rSquare(radius * radius) {
-            }
-
-            bool operator()(const int64_t x, const int64_t y) {
-                const int64_t distSquare = x * x + y * y;
-                return !( distSquare > rSquare );
-            }
-        };
-
-        struct RingCondition {
-            uint32_t minSquare;
-            uint32_t maxSquare;
+        /// exact test of pixel belonging to thick line, spans are refined with it
+        struct LineCondition {
+            PointI fromPoint;
+            PointI lineVector;
+            RayI orthoRay;
+            Linear parallelLine;
+            uint32_t radius;
 
-            RingCondition(const uint32_t minRadius, const uint32_t maxRadius):
-                minSquare(minRadius * minRadius), maxSquare(maxRadius * maxRadius)
+            LineCondition(const PointI& fromPoint, const PointI& lineVector, const uint32_t radius):
+                fromPoint(fromPoint), lineVector(lineVector), orthoRay( lineVector.ortho() ),
+                parallelLine( Linear::createFromParallel(lineVector) ), radius(radius)
             {
             }
 
             bool operator()(const int64_t x, const int64_t y) {
-                const int64_t distSquare = x * x + y * y;
-                if ( distSquare > maxSquare )
+                const PointI currVector = PointI{x, y} - fromPoint;
+                const int64_t side1 = orthoRay.side( currVector );
+                if (side1 < 0) {
                     return false;
-                if ( distSquare < minSquare )
+                }
+                const PointI toVector = currVector - lineVector;
+                const int64_t side2 = orthoRay.side( toVector );
+                if (side2 > 0) {
+                    return false;
+                }
+                const double dist = parallelLine.distance( currVector );
+                if (dist >= radius) {
                     return false;
+                }
                 return true;
             }
         };
 
-        struct ArcCondition {
-            uint32_t minSquare;
-            uint32_t maxSquare;
-            const RayI& fromRay;
-            const RayI& toRay;
-            bool sum;
+        /// exact test of pixel belonging to quad, pixel have to lie on non-negative side of every edge
+        struct QuadCondition {
+            Linear edges[4];
 
-            ArcCondition(const uint32_t minRadius, const uint32_t maxRadius, const RayI& fromRay, const RayI& toRay, const bool sum):
-                minSquare(minRadius * minRadius), maxSquare(maxRadius * maxRadius),
-                fromRay(fromRay), toRay(toRay), sum(sum)
+            QuadCondition(const PointI& topLeft, const PointI& topRight, const PointI& bottomRight, const PointI& bottomLeft):
+                edges{ Linear::createFromPoints( topLeft, topRight ),
+                       Linear::createFromPoints( topRight, bottomRight ),
+                       Linear::createFromPoints( bottomRight, bottomLeft ),
+                       Linear::createFromPoints( bottomLeft, topLeft ) }
             {
             }
 
-            bool operator()(const int64_t x, const int64_t y) {
-                const int64_t distSquare = x * x + y * y;
-                if ( distSquare > maxSquare )
-                    return false;
-                if ( distSquare < minSquare )
-                    return false;
-
-                if (sum) {
-                    const double fromSide = fromRay.side( x, y );
-                    if ( fromSide < 0.0 ) {
-                        const double toSide = toRay.side( x, y );
-                        if ( toSide > 0.0 ) {
-                            return false;
-                        }
-                    }
-                } else {
-                    const double fromSide = fromRay.side( x, y );
-                    if (fromSide <= 0.0) {
-                        return false;
+            /// narrow span [startX, endX] of row "y" to pixels on non-negative side of edges,
+            /// side of pixel is evaluated exactly as:
+            ///     A * x + B * y + C + bias >= 0
+            /// where "bias" rounds boundary of edge down like Linear::pointSide() does for non-negative
+            /// coordinates, exact integer test does not depend on translation of quad (e.g. to tile or band),
+            /// returns false if row is not covered at all
+            bool clipRow(const int64_t y, int64_t& startX, int64_t& endX) const {
+                for( const Linear& line: edges ) {
+                    int64_t bias = 0;
+                    if (line.B > 0) {
+                        bias = line.B - 1;
+                    } else if (line.B == 0 && line.A > 0) {
+                        bias = line.A - 1;
                     }
-                    const double toSide = toRay.side( x, y );
-                    if (toSide >= 0.0) {
+                    /// condition reduced to form: A * x >= limit
+                    const int64_t limit = -( line.B * y + line.C + bias );
+                    if (line.A > 0) {
+                        startX = std::max( startX, ceilDiv( limit, line.A ) );
+                    } else if (line.A < 0) {
+                        endX = std::min( endX, floorDiv( limit, line.A ) );
+                    } else if (limit > 0) {
                         return false;
                     }
                 }
-
-                return true;
+                return startX <= endX;
             }
         };
 
+        /// integer variant of thick line rasterization for radius 1, spans are calculated from conditions:
+        ///     -s <= lineVector * currVector <= |lineVector|^2 + s
+        ///     |lineVector x currVector| <= sqrt( |lineVector|^2 )
+        /// pixels strictly inside the conditions always belong to line, so exact LineCondition is evaluated
+        /// only for span ends lying on the boundary (where rounding of floating point test decides)
+        void drawThinLine(const ImageView& canvas, const PointI& fromPoint, const PointI& lineVector, const RectI& box, const Image::Pixel& pixColor) {
+            const int64_t dx = lineVector.x;
+            const int64_t dy = lineVector.y;
+            const int64_t lengthSquare = dx * dx + dy * dy;
+            const int64_t sideScale = (dy != 0) ? std::abs( dy ) : std::abs( dx );
+            const int64_t maxCross = isqrt( lengthSquare );
+            const bool exactCross = ( maxCross * maxCross == lengthSquare );
+
+            LineCondition condition( fromPoint, lineVector, 1 );
 
-        template <typename Operator>
-        void drawRectEdges(const PointI& center, const RectI& outerBox, const RectI& innerBox, const Image::Pixel& pixColor, Operator& op) {
-            /// top
-            for( int64_t j = outerBox.a.y; j<=innerBox.a.y; ++j ) {
-                const int64_t diffY = j - center.y;
-                Image::row_access tgtRow = img->row( j );
-                for( int64_t i = outerBox.a.x; i<=outerBox.b.x; ++i ) {
-                    const int64_t diffX = i - center.x;
-                    if ( op(diffX, diffY) ) {
-                        tgtRow[ i ] = pixColor;
-                    }
+            for( int64_t j=box.a.y; j<=box.b.y; ++j ) {
+                const int64_t vy = j - fromPoint.y;
+                int64_t startX = box.a.x - fromPoint.x;
+                int64_t endX = box.b.x - fromPoint.x;
+                bool rowBoundary = false;
+
+                /// between ends of line
+                const int64_t minDot = -sideScale - dy * vy;
+                const int64_t maxDot = lengthSquare + sideScale - dy * vy;
+                if (dx > 0) {
+                    startX = std::max( startX, ceilDiv( minDot, dx ) );
+                    endX = std::min( endX, floorDiv( maxDot, dx ) );
+                } else if (dx < 0) {
+                    startX = std::max( startX, ceilDiv( maxDot, dx ) );
+                    endX = std::min( endX, floorDiv( minDot, dx ) );
+                } else {
+                    if (minDot > 0 || maxDot < 0)
+                        continue;
+                    rowBoundary = (minDot == 0 || maxDot == 0);
                 }
-            }
-
-            /// left and right
-            for( int64_t j = innerBox.a.y; j<=innerBox.b.y; ++j ) {
-                const int64_t diffY = j - center.y;
-                Image::row_access tgtRow = img->row( j );
 
-                /// left
-                for( int64_t i = outerBox.a.x; i<=innerBox.a.x; ++i ) {
-                    const int64_t diffX = i - center.x;
-                    if ( op(diffX, diffY) ) {
-                        tgtRow[ i ] = pixColor;
-                    }
+                /// distance from line
+                const int64_t crossBase = dx * vy;
+                if (dy > 0) {
+                    startX = std::max( startX, ceilDiv( crossBase - maxCross, dy ) );
+                    endX = std::min( endX, floorDiv( crossBase + maxCross, dy ) );
+                } else if (dy < 0) {
+                    startX = std::max( startX, ceilDiv( crossBase + maxCross, dy ) );
+                    endX = std::min( endX, floorDiv( crossBase - maxCross, dy ) );
+                } else {
+                    if (std::abs( crossBase ) > maxCross)
+                        continue;
+                    rowBoundary = rowBoundary || (exactCross && std::abs( crossBase ) == maxCross);
                 }
 
-                /// right
-                for( int64_t i = innerBox.b.x; i<=outerBox.b.x; ++i ) {
-                    const int64_t diffX = i - center.x;
-                    if ( op(diffX, diffY) ) {
-                        tgtRow[ i ] = pixColor;
-                    }
+                if (startX > endX)
+                    continue;
+
+                auto onBoundary = [&](const int64_t vx) {
+                    const int64_t dot = dx * vx + dy * vy;
+                    if (dot == -sideScale || dot == lengthSquare + sideScale)
+                        return true;
+                    return exactCross && std::abs( crossBase - dy * vx ) == maxCross;
+                };
+
+                startX += fromPoint.x;
+                endX += fromPoint.x;
+                if (rowBoundary || onBoundary( startX - fromPoint.x )) {
+                    while (startX <= endX && condition( startX, j ) == false)
+                        ++startX;
                 }
-            }
-
-            /// bottom
-            for( int64_t j = innerBox.b.y; j<=outerBox.b.y; ++j ) {
-                const int64_t diffY = j - center.y;
-                Image::row_access tgtRow = img->row( j );
-                for( int64_t i = outerBox.a.x; i<=outerBox.b.x; ++i ) {
-                    const int64_t diffX = i - center.x;
-                    if ( op(diffX, diffY) ) {
-                        tgtRow[ i ] = pixColor;
-                    }
+                if (rowBoundary || onBoundary( endX - fromPoint.x )) {
+                    while (endX >= startX && condition( endX, j ) == false)
+                        --endX;
                 }
+                if (startX > endX)
+                    continue;
+                canvas.fillRect( startX, j, endX + 1, j + 1, pixColor );
+                markChanged( pixColor );
             }
         }
 
+        /// fill pixels of row "y" satisfying "op", pixels have to form single span in range [minX, maxX],
+        /// estimated span [startX, endX] is corrected by testing pixels on its ends
         template <typename Operator>
-        void drawCircleEdges(const PointI& center, const RectI& outerBox, const RectI& innerBox, const Image::Pixel& pixColor, Operator& op) {
-            /// top
-            for( int64_t j = outerBox.a.y; j<=innerBox.a.y; ++j ) {
-                const int64_t diffY = j - center.y;
-                Image::row_access tgtRow = img->row( j );
-                for( int64_t i = innerBox.a.x; i<=innerBox.b.x; ++i ) {
-                    const int64_t diffX = i - center.x;
-                    if ( op(diffX, diffY) ) {
-                        tgtRow[ i ] = pixColor;
+        void fillSpan(const ImageView& canvas, const int64_t y, int64_t startX, int64_t endX,
+                             const int64_t minX, const int64_t maxX, const Image::Pixel& pixColor, Operator& op)
+        {
+            startX = std::max( startX, minX );
+            endX = std::min( endX, maxX );
+            while (startX <= endX && op( startX, y ) == false)
+                ++startX;
+            while (endX >= startX && op( endX, y ) == false)
+                --endX;
+            if (startX > endX)
+                return ;
+            while (startX > minX && op( startX - 1, y ))
+                --startX;
+            while (endX < maxX && op( endX + 1, y ))
+                ++endX;
+            canvas.fillRect( startX, y, endX + 1, y + 1, pixColor );
+            markChanged( pixColor );
+        }
+
+        /// calls "operation( diffY, y, startX, endX )" for every span of ring (minRadius^2 <= x^2 + y^2 <= maxRadius^2)
+        /// visible on canvas, "diffY", "startX" and "endX" are relative to center, "y" is row of canvas
+        template <typename Operation>
+        static void scanRing(const ImageView& canvas, const PointI& center, const uint32_t minRadius, const uint32_t maxRadius, Operation operation) {
+            const int64_t w = canvas.width();
+            const int64_t h = canvas.height();
+            if (w < 1 || h < 1)
+                return ;
+            const int64_t minX = -center.x;
+            const int64_t maxX = w - 1 - center.x;
+            const int64_t maxSquare = (int64_t) maxRadius * maxRadius;
+            const int64_t minSquare = (int64_t) minRadius * minRadius;
+
+            /// half-widths only decrease when going away from center, so they are updated incrementally
+            int64_t outerHalf = maxRadius;          /// largest "x" satisfying: x^2 + y^2 <= maxRadius^2
+            int64_t innerHalf = minRadius;          /// largest "x" satisfying: x^2 + y^2 < minRadius^2, negative if none
+            for( int64_t distY = 0; distY <= maxRadius; ++distY ) {
+                const int64_t ySquare = distY * distY;
+                while (outerHalf * outerHalf + ySquare > maxSquare)
+                    --outerHalf;
+                while (innerHalf >= 0 && innerHalf * innerHalf + ySquare >= minSquare)
+                    --innerHalf;
+
+                for( const int64_t diffY: { distY, -distY } ) {
+                    const int64_t y = center.y + diffY;
+                    if (y >= 0 && y < h) {
+                        if (innerHalf < 0) {
+                            emitSpan( diffY, y, -outerHalf, outerHalf, minX, maxX, operation );
+                        } else {
+                            emitSpan( diffY, y, -outerHalf, -innerHalf - 1, minX, maxX, operation );
+                            emitSpan( diffY, y, innerHalf + 1, outerHalf, minX, maxX, operation );
+                        }
                     }
+                    if (distY == 0)
+                        break;
                 }
             }
+        }
 
-            /// left and right
-            for( int64_t j = innerBox.a.y; j<=innerBox.b.y; ++j ) {
-                const int64_t diffY = j - center.y;
-                Image::row_access tgtRow = img->row( j );
-
-                /// left
-                for( int64_t i = outerBox.a.x; i<=innerBox.a.x; ++i ) {
-                    const int64_t diffX = i - center.x;
-                    if ( op(diffX, diffY) ) {
-                        tgtRow[ i ] = pixColor;
-                    }
-                }
+        template <typename Operation>
+        static void emitSpan(const int64_t diffY, const int64_t y, int64_t startX, int64_t endX, const int64_t minX, const int64_t maxX, Operation& operation) {
+            startX = std::max( startX, minX );
+            endX = std::min( endX, maxX );
+            if (startX <= endX)
+                operation( diffY, y, startX, endX );
+        }
 
-                /// right
-                for( int64_t i = innerBox.b.x; i<=outerBox.b.x; ++i ) {
-                    const int64_t diffX = i - center.x;
-                    if ( op(diffX, diffY) ) {
-                        tgtRow[ i ] = pixColor;
-                    }
-                }
+        /// narrow span [startX, endX] of row "diffY" (relative to ray origin) to pixels lying
+        /// on left ("leftSide" set) or right side of ray, the same way as RayI::side() decides,
+        /// side changes linearly along row, so boundary is calculated once and corrected on its ends
+        static void clipRaySide(const RayI& ray, const int64_t diffY, const bool leftSide, int64_t& startX, int64_t& endX) {
+            if (startX > endX)
+                return ;
+            auto onSide = [&](const int64_t x) {
+                const double side = ray.side( x, diffY );
+                return leftSide ? (side > 0.0) : (side < 0.0);
+            };
+            if (ray.vector.y == 0) {
+                /// side is constant along row
+                if (onSide( startX ) == false)
+                    startX = endX + 1;
+                return ;
             }
 
-            /// bottom
-            for( int64_t j = innerBox.b.y; j<=outerBox.b.y; ++j ) {
-                const int64_t diffY = j - center.y;
-                Image::row_access tgtRow = img->row( j );
-                for( int64_t i = innerBox.a.x; i<=innerBox.b.x; ++i ) {
-                    const int64_t diffX = i - center.x;
-                    if ( op(diffX, diffY) ) {
-                        tgtRow[ i ] = pixColor;
-                    }
-                }
+            /// side decreases along row if ray points downwards
+            const bool increasing = ( (ray.vector.y > 0) != leftSide );
+            const double crossX = (double) diffY * ray.vector.x / ray.vector.y;
+            int64_t boundary = startX;
+            if (crossX > endX + 1) {
+                boundary = endX + 1;
+            } else if (crossX > startX) {
+                boundary = std::floor( crossX );
+            }
+            if (increasing) {
+                /// find first pixel on side
+                while (boundary > startX && onSide( boundary - 1 ))
+                    --boundary;
+                while (boundary <= endX && onSide( boundary ) == false)
+                    ++boundary;
+                startX = boundary;
+            } else {
+                /// find first pixel not on side
+                while (boundary > startX && onSide( boundary - 1 ) == false)
+                    --boundary;
+                while (boundary <= endX && onSide( boundary ))
+                    ++boundary;
+                endX = boundary - 1;
             }
         }
 
@@ -415,23 +554,25 @@ namespace imgdraw2d {
         DifferenceModeWorker(Image* image): ModeWorker(image) {
         }
 
-        void drawImage(const PointI& point, const Image& source) override {
-            assert( point.x >= 0 );
-            assert( point.y >= 0 );
+        void drawImage(const PointI& point, const ConstImageView& source) override {
+            ImageView canvas = target();
             const int64_t x = point.x;
             const int64_t y = point.y;
-            const int64_t w = img->width();
-            const int64_t h = img->height();
+            const int64_t w = canvas.width();
+            const int64_t h = canvas.height();
             const int64_t endW = std::min(w, x + source.width() );
             const int64_t endH = std::min(h, y + source.height() );
-            for( int64_t j = y; j<endH; ++j ) {
+            if (std::max( x, (int64_t) 0 ) >= endW)
+                return ;
+            for( int64_t j = std::max( y, (int64_t) 0 ); j<endH; ++j ) {
                 Image::row_const_access srcRow = source.row( j - y );
-                Image::row_access tgtRow = img->row(j);
-                for( int64_t i = x; i<endW; ++i ) {
+                Image::row_access tgtRow = canvas.row(j);
+                for( int64_t i = std::max( x, (int64_t) 0 ); i<endW; ++i ) {
                     const Image::Pixel& src = srcRow[ i - x ];
                     const Image::Pixel& orig = tgtRow[ i ];
                     tgtRow[ i ] = diffPixels(orig, src);
                 }
+                markChanged();
             }
         }
 
@@ -441,20 +582,22 @@ namespace imgdraw2d {
         }
 
         void fillRect(const PointI& point, const uint32_t width, const uint32_t height, const Image::Pixel& pixColor) override {
-            assert( point.x >= 0 );
-            assert( point.y >= 0 );
-            const int64_t x = point.x;
-            const int64_t y = point.y;
-            const int64_t w = img->width();
-            const int64_t h = img->height();
-            const int64_t endW = std::min(w, x + width );
-            const int64_t endH = std::min(h, y + height );
+            ImageView canvas = target();
+            const int64_t x = std::max( point.x, (int64_t) 0 );
+            const int64_t y = std::max( point.y, (int64_t) 0 );
+            const int64_t w = canvas.width();
+            const int64_t h = canvas.height();
+            const int64_t endW = std::min(w, point.x + width );
+            const int64_t endH = std::min(h, point.y + height );
+            if (x >= endW)
+                return ;
             for( int64_t j = y; j<endH; ++j ) {
-                Image::row_access tgtRow = img->row(j);
+                Image::row_access tgtRow = canvas.row(j);
                 for( int64_t i = x; i<endW; ++i ) {
                     const Image::Pixel& orig = tgtRow[ i ];
                     tgtRow[ i ] = diffPixels(orig, pixColor);
                 }
+                markChanged();
             }
         }
 
@@ -463,6 +606,23 @@ namespace imgdraw2d {
             throw std::runtime_error("fillRect not implemented");
         }
 
+        void fillPolygon(const std::vector<PointI>& polygon, const Image::Pixel& pixColor) override {
+            ImageView canvas = target();
+            const int64_t w = canvas.width();
+            const int64_t h = canvas.height();
+            if (w < 1 || h < 1)
+                return ;
+            const EdgeTable table( polygon );
+            table.scan( RectI( 0, 0, w-1, h-1 ), [&](const int64_t y, const int64_t startX, const int64_t endX) {
+                Image::row_access tgtRow = canvas.row(y);
+                for( int64_t i = startX; i<=endX; ++i ) {
+                    const Image::Pixel& orig = tgtRow[ i ];
+                    tgtRow[ i ] = diffPixels(orig, pixColor);
+                }
+                markChanged();
+            } );
+        }
+
         void drawArc(const PointI& /*center*/, const uint32_t /*radius*/, const uint32_t /*width*/, const double /*startAngle*/, const double /*range*/, const Image::Pixel& /*pixColor*/) override {
             //TODO: implement
             throw std::runtime_error("drawArc not implemented");
@@ -497,11 +657,23 @@ namespace imgdraw2d {
     /// ====================================================================================================
 
 
-    Painter::Painter(Image& image): painter::ModeWorker(&image), mode(CM_DESTINATION), worker(nullptr) {
+    Painter::Painter(Image& image): painter::ModeWorker(&image), mode(CM_DESTINATION), worker(nullptr), tiles(nullptr), recorder(nullptr) {
+        setCompositionMode(mode);
+    }
+
+    Painter::Painter(Image* image): painter::ModeWorker(image), mode(CM_DESTINATION), worker(nullptr), tiles(nullptr), recorder(nullptr) {
+        setCompositionMode(mode);
+    }
+
+    Painter::Painter(const ImageView& view): painter::ModeWorker(view), mode(CM_DESTINATION), worker(nullptr), tiles(nullptr), recorder(nullptr) {
+        setCompositionMode(mode);
+    }
+
+    Painter::Painter(TiledImage& canvas): painter::ModeWorker(ImageView()), mode(CM_DESTINATION), worker(nullptr), tiles(&canvas), recorder(nullptr) {
         setCompositionMode(mode);
     }
 
-    Painter::Painter(Image* image): painter::ModeWorker(image), mode(CM_DESTINATION), worker(nullptr) {
+    Painter::Painter(DisplayList& commands): painter::ModeWorker(ImageView()), mode(CM_DESTINATION), worker(nullptr), tiles(nullptr), recorder(&commands) {
         setCompositionMode(mode);
     }
 
@@ -510,13 +682,129 @@ namespace imgdraw2d {
         switch( mode ) {
         case CM_DESTINATION: {
             worker.reset( new DestinationModeWorker(img) );
-            return ;
+            break ;
         }
         case CM_DIFFERENCE: {
             worker.reset( new DifferenceModeWorker(img) );
+            break ;
+        }
+        }
+        if (img == nullptr) {
+            worker->setImage( region );
+        }
+    }
+
+    template <typename Operation>
+    void Painter::paint(const RectI& area, Operation operation) {
+        if (recorder != nullptr) {
+            recorder->record( area, mode, operation );
             return ;
         }
+        if (tiles == nullptr) {
+            operation( *worker, PointI(0, 0) );
+            return ;
+        }
+        /// not allocated tile is kept only if primitive wrote any of its pixels,
+        /// background color written on it does not change it
+        const Image::Pixel background = tiles->background();
+        worker->blankColor = &background;
+        const RectI range = tiles->tileRange( area );
+        for( int64_t row = range.a.y; row <= range.b.y; ++row ) {
+            for( int64_t column = range.a.x; column <= range.b.x; ++column ) {
+                Image& tile = tiles->acquireTile( column, row );
+                worker->setImage( ImageView( tile ) );
+                worker->changed = false;
+                operation( *worker, tiles->tileOrigin( column, row ) );
+                tiles->commitTile( column, row, worker->changed );
+            }
         }
+        worker->blankColor = nullptr;
+    }
+
+    void Painter::drawImage(const PointI& point, const ConstImageView& source) {
+        if (source.width() < 1 || source.height() < 1)
+            return ;
+        const RectI area( point, point + PointI( source.width() - 1, source.height() - 1 ) );
+        if (recorder != nullptr) {
+            /// recorded command have to own pixels
+            const std::shared_ptr<Image> copy = std::make_shared<Image>( source.width(), source.height() );
+            copy->pasteImage( 0, 0, source );
+            recorder->record( area, mode, [point, copy](painter::ModeWorker& target, const PointI& offset) {
+                target.drawImage( point - offset, ConstImageView( *copy ) );
+            } );
+            return ;
+        }
+        paint( area, [&](painter::ModeWorker& target, const PointI& offset) {
+            target.drawImage( point - offset, source );
+        } );
+    }
+
+    void Painter::drawLine(const PointI& fromPoint, const PointI& toPoint, const uint32_t width, const Image::Pixel& pixColor) {
+        const uint32_t radius = std::max( width / 2, (uint32_t) 1 );
+        RectI area = RectI::minmax( fromPoint, toPoint );
+        area.expand( radius );
+        paint( area, [=](painter::ModeWorker& target, const PointI& offset) {
+            target.drawLine( fromPoint - offset, toPoint - offset, width, pixColor );
+        } );
+    }
+
+    void Painter::drawArc(const PointI& center, const uint32_t radius, const uint32_t width, const double startAngle, const double range, const Image::Pixel& pixColor) {
+        RectI area( center );
+        area.expand( radius + std::max( width / 2, (uint32_t) 1 ) );
+        paint( area, [=](painter::ModeWorker& target, const PointI& offset) {
+            target.drawArc( center - offset, radius, width, startAngle, range, pixColor );
+        } );
+    }
+
+    void Painter::drawRing(const PointI& center, const uint32_t radius, const uint32_t width, const Image::Pixel& pixColor) {
+        RectI area( center );
+        area.expand( radius + std::max( width / 2, (uint32_t) 1 ) );
+        paint( area, [=](painter::ModeWorker& target, const PointI& offset) {
+            target.drawRing( center - offset, radius, width, pixColor );
+        } );
+    }
+
+    void Painter::fillRect(const PointI& point, const uint32_t width, const uint32_t height, const Image::Pixel& pixColor) {
+        if (width < 1 || height < 1)
+            return ;
+        const RectI area( point, point + PointI( width - 1, height - 1 ) );
+        paint( area, [=](painter::ModeWorker& target, const PointI& offset) {
+            target.fillRect( point - offset, width, height, pixColor );
+        } );
+    }
+
+    void Painter::fillRect(const PointI& topLeft, const PointI& topRight, const PointI& bottomRight, const PointI& bottomLeft, const Image::Pixel& pixColor) {
+        RectI area = RectI::minmax( topLeft, topRight );
+        area.expand( bottomRight );
+        area.expand( bottomLeft );
+        paint( area, [=](painter::ModeWorker& target, const PointI& offset) {
+            target.fillRect( topLeft - offset, topRight - offset, bottomRight - offset, bottomLeft - offset, pixColor );
+        } );
+    }
+
+    void Painter::fillPolygon(const std::vector<PointI>& polygon, const Image::Pixel& pixColor) {
+        if (polygon.empty())
+            return ;
+        RectI area( polygon.front() );
+        for( const PointI& point: polygon ) {
+            area.expand( point );
+        }
+        paint( area, [=](painter::ModeWorker& target, const PointI& offset) {
+            std::vector<PointI> shifted;
+            shifted.reserve( polygon.size() );
+            for( const PointI& point: polygon ) {
+                shifted.push_back( point - offset );
+            }
+            target.fillPolygon( shifted, pixColor );
+        } );
+    }
+
+    void Painter::fillCircle(const PointI& center, const uint32_t radius, const Image::Pixel& pixColor) {
+        RectI area( center );
+        area.expand( radius );
+        paint( area, [=](painter::ModeWorker& target, const PointI& offset) {
+            target.fillCircle( center - offset, radius, pixColor );
+        } );
     }
 
 } /* namespace imgdraw2d */
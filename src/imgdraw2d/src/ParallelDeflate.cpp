@@ -0,0 +1,150 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "ParallelDeflate.h"
+
+#include <zlib.h>
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+
+namespace imgdraw2d {
+    namespace parallel {
+
+        static const std::size_t WINDOW_SIZE = 32768;
+
+
+        void forEach(const std::size_t count, const unsigned threads, const std::function<void(std::size_t)>& task) {
+            std::atomic<std::size_t> next( 0 );
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            const auto work = [&]() {
+                for( std::size_t i = next++; i < count; i = next++ ) {
+                    try {
+                        task( i );
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock( errorMutex );
+                        if (error == nullptr)
+                            error = std::current_exception();
+                        next = count;
+                    }
+                }
+            };
+
+            const std::size_t workersNum = std::min( (std::size_t) std::max( threads, 1u ), count );
+            std::vector<std::thread> workers;
+            for( std::size_t i=1; i<workersNum; ++i ) {
+                workers.emplace_back( work );
+            }
+            work();                             /// calling thread is one of workers
+            for( std::thread& item: workers ) {
+                item.join();
+            }
+            if (error != nullptr)
+                std::rethrow_exception( error );
+        }
+
+        /// raw deflate of block, dictionary is taken from data preceding the block
+        static void deflateBlock(const uint8_t* data, const std::size_t start, const std::size_t end, const bool last,
+                                 const int level, const int strategy, std::vector<uint8_t>& output)
+        {
+            z_stream stream;
+            stream.zalloc = Z_NULL;
+            stream.zfree = Z_NULL;
+            stream.opaque = Z_NULL;
+            if (deflateInit2( &stream, level, Z_DEFLATED, -15, 8, strategy ) != Z_OK) {
+                throw std::runtime_error( "unable to initialize deflate" );
+            }
+
+            const std::size_t dictSize = std::min( start, WINDOW_SIZE );
+            if (dictSize > 0)
+                deflateSetDictionary( &stream, data + start - dictSize, dictSize );
+
+            output.resize( deflateBound( &stream, end - start ) + 16 );
+            stream.next_in = const_cast<Bytef*>( data + start );
+            stream.avail_in = end - start;
+            std::size_t written = 0;
+            const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+            while (true) {
+                stream.next_out = output.data() + written;
+                stream.avail_out = output.size() - written;
+                const int ret = ::deflate( &stream, flush );
+                written = output.size() - stream.avail_out;
+                if (ret == Z_STREAM_ERROR) {
+                    deflateEnd( &stream );
+                    throw std::runtime_error( "deflate failed" );
+                }
+                if (stream.avail_out > 0 && stream.avail_in == 0 && (last == false || ret == Z_STREAM_END))
+                    break;
+                output.resize( output.size() * 2 );
+            }
+            output.resize( written );
+            deflateEnd( &stream );
+        }
+
+        std::vector<uint8_t> deflate(const std::vector<uint8_t>& data, const std::vector<std::size_t>& blockEnds,
+                                     const int level, const int strategy, const unsigned threads)
+        {
+            const std::size_t blocksNum = blockEnds.size();
+            std::vector< std::vector<uint8_t> > compressed( blocksNum );
+            std::vector<uLong> checksums( blocksNum );
+            forEach( blocksNum, threads, [&](const std::size_t i) {
+                const std::size_t start = (i > 0) ? blockEnds[i - 1] : 0;
+                deflateBlock( data.data(), start, blockEnds[i], i + 1 == blocksNum, level, strategy, compressed[i] );
+                checksums[i] = adler32( adler32( 0L, Z_NULL, 0 ), data.data() + start, blockEnds[i] - start );
+            } );
+
+            /// zlib header: deflate with 32kB window, compression level hint
+            const int levelHint = (level < 0 || level == 6) ? 2 : (level < 2) ? 0 : (level < 6) ? 1 : 3;
+            const uint8_t cmf = 0x78;
+            uint8_t flg = levelHint << 6;
+            flg += (31 - ((cmf << 8) + flg) % 31) % 31;
+
+            std::size_t totalSize = 2 + 4;
+            for( const std::vector<uint8_t>& item: compressed ) {
+                totalSize += item.size();
+            }
+            std::vector<uint8_t> stream;
+            stream.reserve( totalSize );
+            stream.push_back( cmf );
+            stream.push_back( flg );
+            uLong checksum = adler32( 0L, Z_NULL, 0 );
+            for( std::size_t i=0; i<blocksNum; ++i ) {
+                stream.insert( stream.end(), compressed[i].begin(), compressed[i].end() );
+                const std::size_t start = (i > 0) ? blockEnds[i - 1] : 0;
+                checksum = adler32_combine( checksum, checksums[i], blockEnds[i] - start );
+            }
+            for( int shift = 24; shift >= 0; shift -= 8 ) {
+                stream.push_back( (checksum >> shift) & 0xFF );
+            }
+            return stream;
+        }
+
+    }
+} /* namespace imgdraw2d */
@@ -0,0 +1,55 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_SRC_PARALLELDEFLATE_H_
+#define IMGDRAW2D_SRC_PARALLELDEFLATE_H_
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace imgdraw2d {
+    namespace parallel {
+
+        /// call "task" for every index from [0, count) on up to "threads" threads,
+        /// first exception thrown by task is rethrown in calling thread
+        void forEach(const std::size_t count, const unsigned threads, const std::function<void(std::size_t)>& task);
+
+        /**
+         * Compress data as one zlib stream using many threads (the same way as pigz does).
+         *
+         * Every block ends at given offset and is deflated independently with
+         * preceding 32kB of data as dictionary. Blocks are terminated with sync
+         * flush, so they are byte aligned and can be joined. Checksum is combined
+         * from checksums of blocks.
+         */
+        std::vector<uint8_t> deflate(const std::vector<uint8_t>& data, const std::vector<std::size_t>& blockEnds,
+                                     const int level, const int strategy, const unsigned threads);
+
+    }
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_SRC_PARALLELDEFLATE_H_ */
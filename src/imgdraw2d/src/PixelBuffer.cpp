@@ -0,0 +1,71 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "imgdraw2d/PixelBuffer.h"
+
+#include <utility>
+
+
+namespace imgdraw2d {
+
+    PixelBuffer::PixelBuffer(const std::size_t size): memory(nullptr), aligned(nullptr), capacity(0) {
+        if (size == 0)
+            return ;
+        memory = new uint8_t[ size + ALIGNMENT - 1 ];
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>( memory );
+        const std::size_t shift = ( ALIGNMENT - address % ALIGNMENT ) % ALIGNMENT;
+        aligned = memory + shift;
+        capacity = size;
+    }
+
+    PixelBuffer::PixelBuffer(PixelBuffer&& other): memory(other.memory), aligned(other.aligned), capacity(other.capacity) {
+        other.memory = nullptr;
+        other.aligned = nullptr;
+        other.capacity = 0;
+    }
+
+    PixelBuffer::~PixelBuffer() {
+        clear();
+    }
+
+    PixelBuffer& PixelBuffer::operator=(PixelBuffer&& other) {
+        PixelBuffer tmp( std::move(other) );
+        swap( tmp );
+        return *this;
+    }
+
+    void PixelBuffer::swap(PixelBuffer& other) {
+        std::swap( memory, other.memory );
+        std::swap( aligned, other.aligned );
+        std::swap( capacity, other.capacity );
+    }
+
+    void PixelBuffer::clear() {
+        delete[] memory;
+        memory = nullptr;
+        aligned = nullptr;
+        capacity = 0;
+    }
+
+} /* namespace imgdraw2d */
@@ -0,0 +1,185 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "PixelKernels.h"
+
+#include <cstring>
+
+#if ( defined(__GNUC__) || defined(__clang__) ) && ( defined(__x86_64__) || defined(__i386__) )
+    #define IMGDRAW2D_X86_KERNELS
+    #include <immintrin.h>
+#endif
+
+
+namespace imgdraw2d {
+    namespace kernels {
+
+        /// copies bigger than this value (in pixels) bypass cache with streaming stores
+        static const std::size_t STREAM_THRESHOLD = 256 * 1024;
+
+
+        static void fillScalar(uint32_t* target, const std::size_t count, const uint32_t value) {
+            for( std::size_t i = 0; i<count; ++i ) {
+                target[i] = value;
+            }
+        }
+
+        static void copyScalar(uint32_t* target, const uint32_t* source, const std::size_t count) {
+            std::memcpy( target, source, count * sizeof(uint32_t) );
+        }
+
+
+#ifdef IMGDRAW2D_X86_KERNELS
+
+        __attribute__((target("sse2")))
+        static void fillSSE2(uint32_t* target, const std::size_t count, const uint32_t value) {
+            std::size_t i = 0;
+            /// align destination to 16 bytes
+            for( ; i<count && ( reinterpret_cast<std::uintptr_t>(target + i) % 16 ) != 0; ++i ) {
+                target[i] = value;
+            }
+            const __m128i pattern = _mm_set1_epi32( (int) value );
+            for( ; i + 16 <= count; i += 16 ) {
+                __m128i* dst = reinterpret_cast<__m128i*>( target + i );
+                _mm_store_si128( dst + 0, pattern );
+                _mm_store_si128( dst + 1, pattern );
+                _mm_store_si128( dst + 2, pattern );
+                _mm_store_si128( dst + 3, pattern );
+            }
+            for( ; i + 4 <= count; i += 4 ) {
+                _mm_store_si128( reinterpret_cast<__m128i*>( target + i ), pattern );
+            }
+            for( ; i<count; ++i ) {
+                target[i] = value;
+            }
+        }
+
+        __attribute__((target("sse2")))
+        static void copySSE2(uint32_t* target, const uint32_t* source, const std::size_t count) {
+            if (count < STREAM_THRESHOLD) {
+                std::memcpy( target, source, count * sizeof(uint32_t) );
+                return ;
+            }
+            std::size_t i = 0;
+            for( ; i<count && ( reinterpret_cast<std::uintptr_t>(target + i) % 16 ) != 0; ++i ) {
+                target[i] = source[i];
+            }
+            for( ; i + 4 <= count; i += 4 ) {
+                const __m128i data = _mm_loadu_si128( reinterpret_cast<const __m128i*>( source + i ) );
+                _mm_stream_si128( reinterpret_cast<__m128i*>( target + i ), data );
+            }
+            _mm_sfence();
+            for( ; i<count; ++i ) {
+                target[i] = source[i];
+            }
+        }
+
+        __attribute__((target("avx2")))
+        static void fillAVX2(uint32_t* target, const std::size_t count, const uint32_t value) {
+            std::size_t i = 0;
+            /// align destination to 32 bytes
+            for( ; i<count && ( reinterpret_cast<std::uintptr_t>(target + i) % 32 ) != 0; ++i ) {
+                target[i] = value;
+            }
+            const __m256i pattern = _mm256_set1_epi32( (int) value );
+            for( ; i + 32 <= count; i += 32 ) {
+                __m256i* dst = reinterpret_cast<__m256i*>( target + i );
+                _mm256_store_si256( dst + 0, pattern );
+                _mm256_store_si256( dst + 1, pattern );
+                _mm256_store_si256( dst + 2, pattern );
+                _mm256_store_si256( dst + 3, pattern );
+            }
+            for( ; i + 8 <= count; i += 8 ) {
+                _mm256_store_si256( reinterpret_cast<__m256i*>( target + i ), pattern );
+            }
+            for( ; i<count; ++i ) {
+                target[i] = value;
+            }
+        }
+
+        __attribute__((target("avx2")))
+        static void copyAVX2(uint32_t* target, const uint32_t* source, const std::size_t count) {
+            if (count < STREAM_THRESHOLD) {
+                std::memcpy( target, source, count * sizeof(uint32_t) );
+                return ;
+            }
+            std::size_t i = 0;
+            for( ; i<count && ( reinterpret_cast<std::uintptr_t>(target + i) % 32 ) != 0; ++i ) {
+                target[i] = source[i];
+            }
+            for( ; i + 8 <= count; i += 8 ) {
+                const __m256i data = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( source + i ) );
+                _mm256_stream_si256( reinterpret_cast<__m256i*>( target + i ), data );
+            }
+            _mm_sfence();
+            for( ; i<count; ++i ) {
+                target[i] = source[i];
+            }
+        }
+
+#endif
+
+
+        /// ======================================================================
+
+
+        struct KernelSet {
+            void (*fill)(uint32_t*, const std::size_t, const uint32_t);
+            void (*copy)(uint32_t*, const uint32_t*, const std::size_t);
+            const char* name;
+        };
+
+        static KernelSet detectKernels() {
+#ifdef IMGDRAW2D_X86_KERNELS
+            __builtin_cpu_init();
+            if ( __builtin_cpu_supports("avx2") ) {
+                return KernelSet{ fillAVX2, copyAVX2, "avx2" };
+            }
+            if ( __builtin_cpu_supports("sse2") ) {
+                return KernelSet{ fillSSE2, copySSE2, "sse2" };
+            }
+#endif
+            return KernelSet{ fillScalar, copyScalar, "scalar" };
+        }
+
+        static const KernelSet& kernelSet() {
+            static const KernelSet kernels = detectKernels();
+            return kernels;
+        }
+
+
+        void fillPixels(uint32_t* target, const std::size_t count, const uint32_t value) {
+            kernelSet().fill( target, count, value );
+        }
+
+        void copyPixels(uint32_t* target, const uint32_t* source, const std::size_t count) {
+            kernelSet().copy( target, source, count );
+        }
+
+        const char* implementation() {
+            return kernelSet().name;
+        }
+
+    }
+} /* namespace imgdraw2d */
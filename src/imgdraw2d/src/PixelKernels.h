@@ -0,0 +1,69 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_SRC_PIXELKERNELS_H_
+#define IMGDRAW2D_SRC_PIXELKERNELS_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+
+namespace imgdraw2d {
+    namespace kernels {
+
+        /// kernels operate on 32-bit RGBA pixels, implementation is selected at runtime (AVX2, SSE2 or scalar)
+
+        /// set "count" pixels starting at "target" to "value"
+        void fillPixels(uint32_t* target, const std::size_t count, const uint32_t value);
+
+        /// copy "count" pixels, regions must not overlap
+        void copyPixels(uint32_t* target, const uint32_t* source, const std::size_t count);
+
+        /// name of selected implementation
+        const char* implementation();
+
+
+        template <typename PixelT>
+        inline uint32_t packPixel(const PixelT& color) {
+            static_assert( sizeof(PixelT) == sizeof(uint32_t), "unsupported pixel size" );
+            uint32_t value = 0;
+            std::memcpy( &value, &color, sizeof(value) );
+            return value;
+        }
+
+        template <typename PixelT>
+        inline uint32_t* pixelWords(PixelT* pixels) {
+            return reinterpret_cast<uint32_t*>( pixels );
+        }
+
+        template <typename PixelT>
+        inline const uint32_t* pixelWords(const PixelT* pixels) {
+            return reinterpret_cast<const uint32_t*>( pixels );
+        }
+
+    }
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_SRC_PIXELKERNELS_H_ */
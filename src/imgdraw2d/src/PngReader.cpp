@@ -0,0 +1,146 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "PngReader.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+
+namespace imgdraw2d {
+
+    static void raiseError(png_structp /*png*/, png_const_charp message) {
+        throw std::runtime_error( std::string("png read error: ") + message );
+    }
+
+    static void ignoreWarning(png_structp /*png*/, png_const_charp /*message*/) {
+    }
+
+    static const std::size_t SIGNATURE_SIZE = 8;
+
+
+    /// ===============================================================================
+
+
+    PngReader::PngReader(const void* data, const std::size_t size):
+        file(nullptr), png(nullptr), info(nullptr), data( static_cast<const uint8_t*>(data) ), size(size), offset(0)
+    {
+        if (size < SIGNATURE_SIZE || png_sig_cmp( this->data, 0, SIGNATURE_SIZE ) != 0) {
+            throw std::runtime_error( "invalid png signature" );
+        }
+        initialize();
+    }
+
+    PngReader::PngReader(const std::string& path):
+        file(nullptr), png(nullptr), info(nullptr), data(nullptr), size(0), offset(0)
+    {
+        file = std::fopen( path.c_str(), "rb" );
+        if (file == nullptr) {
+            throw std::runtime_error( path + ": " + std::strerror( errno ) );
+        }
+        png_byte signature[ SIGNATURE_SIZE ];
+        if (std::fread( signature, 1, SIGNATURE_SIZE, file ) != SIGNATURE_SIZE || png_sig_cmp( signature, 0, SIGNATURE_SIZE ) != 0) {
+            release();
+            throw std::runtime_error( path + ": invalid png signature" );
+        }
+        std::rewind( file );
+        initialize();
+    }
+
+    PngReader::~PngReader() {
+        release();
+    }
+
+    void PngReader::initialize() {
+        png = png_create_read_struct( PNG_LIBPNG_VER_STRING, nullptr, raiseError, ignoreWarning );
+        if (png != nullptr)
+            info = png_create_info_struct( png );
+        if (info == nullptr) {
+            release();
+            throw std::runtime_error( "unable to initialize png reader" );
+        }
+
+        try {
+            if (file != nullptr)
+                png_init_io( png, file );
+            else
+                png_set_read_fn( png, this, readData );
+            png_read_info( png, info );
+
+            /// convert every color type to 8-bit RGBA
+            const png_byte colorType = png_get_color_type( png, info );
+            png_set_expand( png );
+            png_set_strip_16( png );
+            if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+                png_set_gray_to_rgb( png );
+            if ((colorType & PNG_COLOR_MASK_ALPHA) == 0 && png_get_valid( png, info, PNG_INFO_tRNS ) == 0)
+                png_set_add_alpha( png, 0xFF, PNG_FILLER_AFTER );
+            png_set_interlace_handling( png );
+            png_read_update_info( png, info );
+
+            if (png_get_rowbytes( png, info ) != width() * 4) {
+                throw std::runtime_error( "unsupported png pixel layout" );
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    uint32_t PngReader::width() const {
+        return png_get_image_width( png, info );
+    }
+
+    uint32_t PngReader::height() const {
+        return png_get_image_height( png, info );
+    }
+
+    void PngReader::readImage(png_bytepp rows) {
+        png_read_image( png, rows );
+        png_read_end( png, nullptr );
+    }
+
+    void PngReader::readData(png_structp png, png_bytep target, png_size_t length) {
+        PngReader* reader = static_cast<PngReader*>( png_get_io_ptr( png ) );
+        if (length > reader->size - reader->offset) {
+            png_error( png, "unexpected end of data" );
+        }
+        std::memcpy( target, reader->data + reader->offset, length );
+        reader->offset += length;
+    }
+
+    void PngReader::release() {
+        if (png != nullptr) {
+            png_destroy_read_struct( &png, &info, nullptr );
+            png = nullptr;
+            info = nullptr;
+        }
+        if (file != nullptr) {
+            std::fclose( file );
+            file = nullptr;
+        }
+    }
+
+} /* namespace imgdraw2d */
@@ -0,0 +1,87 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_SRC_PNGREADER_H_
+#define IMGDRAW2D_SRC_PNGREADER_H_
+
+#include <png.h>
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Decoder reading PNG file or stream from memory directly with libpng.
+     *
+     * Every color type is expanded to 8-bit RGBA, so rows can be decoded
+     * straight into Image buffer.
+     */
+    class PngReader {
+
+        FILE* file;
+        png_structp png;
+        png_infop info;
+        const uint8_t* data;                /// source if file is not set
+        std::size_t size;
+        std::size_t offset;
+
+
+    public:
+
+        /// reads header, throws std::runtime_error if stream is not valid PNG
+        PngReader(const void* data, const std::size_t size);
+
+        /// reads header, throws std::runtime_error if file can not be opened or it is not valid PNG
+        PngReader(const std::string& path);
+
+        ~PngReader();
+
+        PngReader(const PngReader&) = delete;
+        PngReader& operator=(const PngReader&) = delete;
+
+        uint32_t width() const;
+
+        uint32_t height() const;
+
+        /// decode all rows, every row have to hold "width" RGBA pixels
+        void readImage(png_bytepp rows);
+
+
+    private:
+
+        void initialize();
+
+        static void readData(png_structp png, png_bytep target, png_size_t length);
+
+        void release();
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_SRC_PNGREADER_H_ */
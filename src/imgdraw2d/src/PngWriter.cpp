@@ -0,0 +1,483 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "PngWriter.h"
+
+#include "imgdraw2d/ImageView.h"
+#include "PixelKernels.h"
+#include "ParallelDeflate.h"
+
+#include <zlib.h>
+
+#include <boost/filesystem.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace imgdraw2d {
+
+    using kernels::packPixel;
+
+
+    static_assert( Image::SaveOptions::FILTER_NONE  == PNG_FILTER_NONE,  "filter value mismatch" );
+    static_assert( Image::SaveOptions::FILTER_PAETH == PNG_FILTER_PAETH, "filter value mismatch" );
+    static_assert( Image::SaveOptions::FILTER_ALL   == PNG_ALL_FILTERS,  "filter value mismatch" );
+
+
+    static void raiseError(png_structp /*png*/, png_const_charp message) {
+        throw std::runtime_error( std::string("png write error: ") + message );
+    }
+
+    static void ignoreWarning(png_structp /*png*/, png_const_charp /*message*/) {
+    }
+
+    /// ITU-R BT.601 luma
+    inline png_byte luminance(const Image::Pixel& pixel) {
+        return ( 299 * pixel.red + 587 * pixel.green + 114 * pixel.blue + 500 ) / 1000;
+    }
+
+    static int colorType(const Image::PixelFormat format) {
+        switch( format ) {
+        case Image::PF_GRAY8:       return PNG_COLOR_TYPE_GRAY;
+        case Image::PF_GRAY_ALPHA:  return PNG_COLOR_TYPE_GRAY_ALPHA;
+        case Image::PF_RGB24:       return PNG_COLOR_TYPE_RGB;
+        case Image::PF_RGBA32:      return PNG_COLOR_TYPE_RGB_ALPHA;
+        case Image::PF_PALETTE8:    return PNG_COLOR_TYPE_PALETTE;
+        case Image::PF_AUTO:        break;
+        }
+        return PNG_COLOR_TYPE_RGB_ALPHA;
+    }
+
+    /// minimal number of rows compressed by one thread
+    static const uint32_t MIN_BAND_ROWS = 16;
+
+    /// size of IDAT chunks written by parallel encoder
+    static const std::size_t IDAT_CHUNK_SIZE = 256 * 1024;
+
+
+    inline png_byte paethPredictor(const int a, const int b, const int c) {
+        const int p = a + b - c;
+        const int pa = std::abs( p - a );
+        const int pb = std::abs( p - b );
+        const int pc = std::abs( p - c );
+        if (pa <= pb && pa <= pc)
+            return a;
+        if (pb <= pc)
+            return b;
+        return c;
+    }
+
+    /// apply PNG filter of given type to row, "prev" is null for first row of image
+    static void filterRow(const int type, const png_byte* row, const png_byte* prev, const std::size_t size, const std::size_t bpp, png_byte* out) {
+        for( std::size_t i=0; i<size; ++i ) {
+            const int a = (i >= bpp) ? row[i - bpp] : 0;
+            const int b = (prev != nullptr) ? prev[i] : 0;
+            const int c = (i >= bpp && prev != nullptr) ? prev[i - bpp] : 0;
+            switch( type ) {
+            case PNG_FILTER_VALUE_NONE:     out[i] = row[i];                                        break;
+            case PNG_FILTER_VALUE_SUB:      out[i] = row[i] - a;                                    break;
+            case PNG_FILTER_VALUE_UP:       out[i] = row[i] - b;                                    break;
+            case PNG_FILTER_VALUE_AVG:      out[i] = row[i] - ((a + b) >> 1);                       break;
+            case PNG_FILTER_VALUE_PAETH:    out[i] = row[i] - paethPredictor( a, b, c );            break;
+            }
+        }
+    }
+
+    /// filter heuristic of libpng: minimal sum of absolute values of bytes treated as signed
+    static std::size_t filterCost(const png_byte* data, const std::size_t size) {
+        std::size_t sum = 0;
+        for( std::size_t i=0; i<size; ++i ) {
+            sum += (data[i] < 128) ? data[i] : 256 - data[i];
+        }
+        return sum;
+    }
+
+    static int zlibStrategy(const Image::SaveOptions::Strategy strategy) {
+        switch( strategy ) {
+        case Image::SaveOptions::ZS_DEFAULT:        return Z_DEFAULT_STRATEGY;
+        case Image::SaveOptions::ZS_FILTERED:       return Z_FILTERED;
+        case Image::SaveOptions::ZS_HUFFMAN_ONLY:   return Z_HUFFMAN_ONLY;
+        case Image::SaveOptions::ZS_RLE:            return Z_RLE;
+        case Image::SaveOptions::ZS_FIXED:          return Z_FIXED;
+        }
+        return Z_DEFAULT_STRATEGY;
+    }
+
+
+    /// ===============================================================================
+
+
+    PngWriter::PngWriter(const std::string& path, const uint32_t width, const uint32_t height,
+                         const Image::SaveOptions& options, const std::vector<Image::Pixel>& palette):
+        file(nullptr), output(nullptr), png(nullptr), info(nullptr), format(options.format), settings(options), width(width), height(height), rowsWritten(0), bitDepth(8), dataWritten(false), rowBuffer(), indexes()
+    {
+        if (format == Image::PF_AUTO)
+            format = palette.empty() ? Image::PF_RGBA32 : Image::PF_PALETTE8;
+        if (format == Image::PF_PALETTE8 && (palette.empty() || palette.size() > 256)) {
+            throw std::invalid_argument( "palette have to contain from 1 to 256 colors" );
+        }
+
+        file = std::fopen( path.c_str(), "wb" );
+        if (file == nullptr) {
+            throw std::runtime_error( path + ": " + std::strerror( errno ) );
+        }
+
+        initialize( options, palette );
+    }
+
+    PngWriter::PngWriter(std::vector<uint8_t>& output, const uint32_t width, const uint32_t height,
+                         const Image::SaveOptions& options, const std::vector<Image::Pixel>& palette):
+        file(nullptr), output(&output), png(nullptr), info(nullptr), format(options.format), settings(options), width(width), height(height), rowsWritten(0), bitDepth(8), dataWritten(false), rowBuffer(), indexes()
+    {
+        if (format == Image::PF_AUTO)
+            format = palette.empty() ? Image::PF_RGBA32 : Image::PF_PALETTE8;
+        if (format == Image::PF_PALETTE8 && (palette.empty() || palette.size() > 256)) {
+            throw std::invalid_argument( "palette have to contain from 1 to 256 colors" );
+        }
+
+        initialize( options, palette );
+    }
+
+    PngWriter::~PngWriter() {
+        release();
+    }
+
+    void PngWriter::initialize(const Image::SaveOptions& options, const std::vector<Image::Pixel>& palette) {
+        png = png_create_write_struct( PNG_LIBPNG_VER_STRING, nullptr, raiseError, ignoreWarning );
+        if (png != nullptr)
+            info = png_create_info_struct( png );
+        if (info == nullptr) {
+            release();
+            throw std::runtime_error( "unable to initialize png writer" );
+        }
+
+        try {
+            if (file != nullptr)
+                png_init_io( png, file );
+            else
+                png_set_write_fn( png, this, writeData, flushData );
+
+            /// bigger buffer results in less IDAT chunks and write calls
+            png_set_compression_buffer_size( png, IDAT_CHUNK_SIZE );
+            if (options.compressionLevel >= 0)
+                png_set_compression_level( png, std::min( options.compressionLevel, 9 ) );
+            if (options.strategy != Image::SaveOptions::ZS_DEFAULT)
+                png_set_compression_strategy( png, zlibStrategy( options.strategy ) );
+            if (options.filters != Image::SaveOptions::FILTER_DEFAULT)
+                png_set_filter( png, PNG_FILTER_TYPE_BASE, options.filters & Image::SaveOptions::FILTER_ALL );
+            if (format == Image::PF_PALETTE8) {
+                /// smallest depth able to hold all indexes
+                if (palette.size() <= 2)
+                    bitDepth = 1;
+                else if (palette.size() <= 4)
+                    bitDepth = 2;
+                else if (palette.size() <= 16)
+                    bitDepth = 4;
+            }
+            png_set_IHDR( png, info, width, height, bitDepth, colorType( format ), PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT );
+
+            if (format == Image::PF_PALETTE8) {
+                std::vector<png_color> colors( palette.size() );
+                std::vector<png_byte> alpha( palette.size() );
+                std::size_t alphaSize = 0;                      /// skip trailing opaque entries
+                for( std::size_t i=0; i<palette.size(); ++i ) {
+                    const Image::Pixel& item = palette[i];
+                    colors[i].red   = item.red;
+                    colors[i].green = item.green;
+                    colors[i].blue  = item.blue;
+                    alpha[i] = item.alpha;
+                    if (item.alpha != 255)
+                        alphaSize = i + 1;
+                    indexes[ packPixel( item ) ] = i;
+                }
+                png_set_PLTE( png, info, colors.data(), colors.size() );
+                if (alphaSize > 0)
+                    png_set_tRNS( png, info, alpha.data(), alphaSize, nullptr );
+            }
+
+            png_write_info( png, info );
+        } catch (...) {
+            release();
+            throw;
+        }
+
+        if (format != Image::PF_RGBA32)
+            rowBuffer.resize( rowSize() );                  /// RGBA rows are written directly
+    }
+
+    void PngWriter::writeData(png_structp png, png_bytep data, png_size_t length) {
+        PngWriter* writer = static_cast<PngWriter*>( png_get_io_ptr( png ) );
+        writer->output->insert( writer->output->end(), data, data + length );
+    }
+
+    void PngWriter::flushData(png_structp /*png*/) {
+    }
+
+    void PngWriter::writeRow(Image::row_const_access row) {
+        if (format == Image::PF_RGBA32) {
+            /// layout of pixel is the same as in PNG file
+            png_write_row( png, reinterpret_cast<png_const_bytep>( row ) );
+        } else {
+            convertRow( row, rowBuffer.data() );
+            png_write_row( png, rowBuffer.data() );
+        }
+        ++rowsWritten;
+    }
+
+    void PngWriter::writeImage(const ConstImageView& image, const unsigned threads) {
+        const unsigned workers = (threads > 0) ? threads : std::max( std::thread::hardware_concurrency(), 1u );
+        if (workers < 2 || height < 2 * MIN_BAND_ROWS || rowsWritten > 0) {
+            if (format == Image::PF_RGBA32 && rowsWritten == 0) {
+                /// pixels are passed to libpng without copying in one call
+                std::vector<png_bytep> rows( height );
+                for( uint32_t y = 0; y<height; ++y ) {
+                    rows[y] = reinterpret_cast<png_bytep>( const_cast<Image::Pixel*>( image.row(y) ) );
+                }
+                png_write_image( png, rows.data() );
+                rowsWritten = height;
+                return ;
+            }
+            for( uint32_t y = rowsWritten; y<height; ++y ) {
+                writeRow( image.row(y) );
+            }
+            return ;
+        }
+
+        const std::size_t size = rowSize();
+        const std::size_t lineSize = size + 1;              /// filter type and row
+        std::size_t bpp = 4;
+        switch( format ) {
+        case Image::PF_GRAY8:       bpp = 1;    break;
+        case Image::PF_GRAY_ALPHA:  bpp = 2;    break;
+        case Image::PF_RGB24:       bpp = 3;    break;
+        case Image::PF_PALETTE8:    bpp = 1;    break;
+        default:                                break;
+        }
+        int allowed = settings.filters & Image::SaveOptions::FILTER_ALL;
+        if (settings.filters == Image::SaveOptions::FILTER_DEFAULT) {
+            /// the same defaults as in libpng
+            allowed = (format == Image::PF_PALETTE8) ? Image::SaveOptions::FILTER_NONE : Image::SaveOptions::FILTER_ALL;
+        }
+
+        /// bands are small enough to balance load between threads
+        const uint32_t bandRows = std::max( (height + workers * 4 - 1) / (workers * 4), MIN_BAND_ROWS );
+        const std::size_t bandsNum = (height + bandRows - 1) / bandRows;
+        std::vector<uint8_t> filtered( lineSize * height );
+        std::vector<std::size_t> bandEnds( bandsNum );
+        for( std::size_t i=0; i<bandsNum; ++i ) {
+            bandEnds[i] = std::min( (uint32_t) ((i + 1) * bandRows), height ) * lineSize;
+        }
+
+        parallel::forEach( bandsNum, workers, [&](const std::size_t band) {
+            std::vector<png_byte> current( size );
+            std::vector<png_byte> previous( size );
+            std::vector<png_byte> candidate( size );
+            const uint32_t start = band * bandRows;
+            const uint32_t end = std::min( start + bandRows, height );
+            if (start > 0)
+                convertRow( image.row( start - 1 ), previous.data() );
+            for( uint32_t y = start; y<end; ++y ) {
+                convertRow( image.row( y ), current.data() );
+                const png_byte* prev = (y > 0) ? previous.data() : nullptr;
+                png_byte* line = filtered.data() + y * lineSize;
+                std::size_t bestCost = (std::size_t) -1;
+                for( int type = PNG_FILTER_VALUE_NONE; type <= PNG_FILTER_VALUE_PAETH; ++type ) {
+                    if ((allowed & (Image::SaveOptions::FILTER_NONE << type)) == 0)
+                        continue ;
+                    filterRow( type, current.data(), prev, size, bpp, candidate.data() );
+                    const std::size_t cost = filterCost( candidate.data(), size );
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        line[0] = type;
+                        std::copy( candidate.begin(), candidate.end(), line + 1 );
+                    }
+                }
+                std::swap( current, previous );
+            }
+        } );
+
+        const int level = (settings.compressionLevel >= 0) ? std::min( settings.compressionLevel, 9 ) : Z_DEFAULT_COMPRESSION;
+        const std::vector<uint8_t> stream = parallel::deflate( filtered, bandEnds, level, zlibStrategy( settings.strategy ), workers );
+        for( std::size_t offset = 0; offset < stream.size(); offset += IDAT_CHUNK_SIZE ) {
+            const std::size_t chunkSize = std::min( IDAT_CHUNK_SIZE, stream.size() - offset );
+            png_write_chunk( png, reinterpret_cast<png_const_bytep>( "IDAT" ), stream.data() + offset, chunkSize );
+        }
+        rowsWritten = height;
+        dataWritten = true;
+    }
+
+    void PngWriter::close() {
+        if (rowsWritten != height) {
+            release();
+            throw std::logic_error( "not all rows were written" );
+        }
+        if (dataWritten) {
+            /// libpng does not know about IDAT chunks written directly
+            png_write_chunk( png, reinterpret_cast<png_const_bytep>( "IEND" ), nullptr, 0 );
+        } else {
+            png_write_end( png, nullptr );
+        }
+        release();
+    }
+
+    bool PngWriter::collectPalette(const ConstImageView& image, std::vector<Image::Pixel>& palette, const std::size_t maxColors) {
+        std::unordered_map<uint32_t, std::size_t> colors;
+        for( std::size_t i=0; i<palette.size(); ++i ) {
+            colors[ packPixel( palette[i] ) ] = i;
+        }
+        for( uint32_t y=0; y<image.height(); ++y ) {
+            Image::row_const_access row = image.row( y );
+            uint32_t prev = 0;
+            for( uint32_t x=0; x<image.width(); ++x ) {
+                const uint32_t value = packPixel( row[x] );
+                if (x > 0 && value == prev)
+                    continue ;                                  /// plots contain long runs of the same color
+                prev = value;
+                if (colors.insert( std::make_pair( value, palette.size() ) ).second == false)
+                    continue ;
+                if (palette.size() >= maxColors)
+                    return false;
+                palette.push_back( row[x] );
+            }
+        }
+        return true;
+    }
+
+    bool PngWriter::collectPalette(const ConstImageView& image, std::vector<Image::Pixel>& palette, const Image::PixelFormat format) {
+        if (collectPalette( image, palette ))
+            return true;
+        if (format == Image::PF_PALETTE8)
+            throw std::invalid_argument( "too many colors for palette format" );
+        palette.clear();
+        return false;
+    }
+
+    /// "target" is file path or memory buffer
+    template <typename Target>
+    static void writePixel(Target& target, const Image::Pixel& color, const Image::SaveOptions& options) {
+        const std::vector<Image::Pixel> palette( 1, color );
+        PngWriter writer( target, 1, 1, options, palette );
+        writer.writeRow( &color );
+        writer.close();
+    }
+
+    void PngWriter::writeEmpty(const std::string& path, const Image::Pixel& color, const Image::SaveOptions& options) {
+        writePixel( path, color, options );
+    }
+
+    void PngWriter::writeEmpty(std::vector<uint8_t>& output, const Image::Pixel& color, const Image::SaveOptions& options) {
+        writePixel( output, color, options );
+    }
+
+    void PngWriter::createParentDirectory(const std::string& path) {
+        const boost::filesystem::path fileDir = boost::filesystem::path( path ).parent_path();
+        if (fileDir.empty() == false)
+            boost::filesystem::create_directories( fileDir );
+    }
+
+    std::size_t PngWriter::rowSize() const {
+        switch( format ) {
+        case Image::PF_GRAY8:       return width;
+        case Image::PF_GRAY_ALPHA:  return width * 2;
+        case Image::PF_RGB24:       return width * 3;
+        case Image::PF_PALETTE8:    return (width * bitDepth + 7) / 8;
+        case Image::PF_RGBA32:
+        case Image::PF_AUTO:        break;
+        }
+        return width * 4;
+    }
+
+    void PngWriter::convertRow(Image::row_const_access row, png_byte* out) const {
+        switch( format ) {
+        case Image::PF_GRAY8: {
+            for( uint32_t x=0; x<width; ++x ) {
+                out[x] = luminance( row[x] );
+            }
+            break;
+        }
+        case Image::PF_GRAY_ALPHA: {
+            for( uint32_t x=0; x<width; ++x ) {
+                out[ 2*x ]     = luminance( row[x] );
+                out[ 2*x + 1 ] = row[x].alpha;
+            }
+            break;
+        }
+        case Image::PF_RGB24: {
+            for( uint32_t x=0; x<width; ++x ) {
+                out[ 3*x ]     = row[x].red;
+                out[ 3*x + 1 ] = row[x].green;
+                out[ 3*x + 2 ] = row[x].blue;
+            }
+            break;
+        }
+        case Image::PF_PALETTE8: {
+            uint32_t prev = 0;
+            png_byte index = 0;
+            if (bitDepth < 8)
+                std::fill( out, out + rowSize(), 0 );
+            const uint32_t perByte = 8 / bitDepth;
+            for( uint32_t x=0; x<width; ++x ) {
+                const uint32_t value = packPixel( row[x] );
+                if (x == 0 || value != prev) {
+                    std::unordered_map<uint32_t, png_byte>::const_iterator iter = indexes.find( value );
+                    if (iter == indexes.end())
+                        throw std::invalid_argument( "color missing in palette" );
+                    index = iter->second;
+                    prev = value;
+                }
+                if (bitDepth == 8) {
+                    out[x] = index;
+                } else {
+                    /// leftmost pixel in high-order bits
+                    const uint32_t shift = 8 - bitDepth * (x % perByte + 1);
+                    out[ x / perByte ] |= index << shift;
+                }
+            }
+            break;
+        }
+        case Image::PF_RGBA32:
+        case Image::PF_AUTO: {
+            std::memcpy( out, row, width * 4 );
+            break;
+        }
+        }
+    }
+
+    void PngWriter::release() {
+        if (png != nullptr) {
+            png_destroy_write_struct( &png, &info );
+            png = nullptr;
+            info = nullptr;
+        }
+        if (file != nullptr) {
+            std::fclose( file );
+            file = nullptr;
+        }
+    }
+
+} /* namespace imgdraw2d */
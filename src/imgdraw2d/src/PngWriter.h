@@ -0,0 +1,137 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef IMGDRAW2D_SRC_PNGWRITER_H_
+#define IMGDRAW2D_SRC_PNGWRITER_H_
+
+#include "imgdraw2d/Image.h"
+
+#include <png.h>
+
+#include <vector>
+#include <unordered_map>
+#include <cstdio>
+
+
+namespace imgdraw2d {
+
+    /**
+     * Encoder writing PNG file or memory buffer row by row directly with libpng.
+     *
+     * Rows are converted to requested pixel format while writing,
+     * so converted copy of whole image is never created.
+     *
+     * Whole image can be also filtered and compressed on many threads
+     * (see writeImage()), then filtered copy of image is kept in memory.
+     */
+    class PngWriter {
+
+        FILE* file;
+        std::vector<uint8_t>* output;                       /// target buffer if file is not set
+        png_structp png;
+        png_infop info;
+        Image::PixelFormat format;
+        Image::SaveOptions settings;
+        uint32_t width;
+        uint32_t height;
+        uint32_t rowsWritten;
+        int bitDepth;
+        bool dataWritten;                                   /// IDAT chunks were written by writeImage()
+        std::vector<png_byte> rowBuffer;                    /// converted row
+        std::unordered_map<uint32_t, png_byte> indexes;     /// packed color -> palette index
+
+
+    public:
+
+        /// "palette" is required by PF_PALETTE8 format, it can contain up to 256 colors,
+        /// PF_AUTO is written as PF_PALETTE8 if palette is given and as PF_RGBA32 otherwise
+        PngWriter(const std::string& path, const uint32_t width, const uint32_t height,
+                  const Image::SaveOptions& options = Image::SaveOptions(),
+                  const std::vector<Image::Pixel>& palette = std::vector<Image::Pixel>() );
+
+        /// encoded stream is appended to "output"
+        PngWriter(std::vector<uint8_t>& output, const uint32_t width, const uint32_t height,
+                  const Image::SaveOptions& options = Image::SaveOptions(),
+                  const std::vector<Image::Pixel>& palette = std::vector<Image::Pixel>() );
+
+        ~PngWriter();
+
+        PngWriter(const PngWriter&) = delete;
+        PngWriter& operator=(const PngWriter&) = delete;
+
+        /// row have to contain "width" pixels
+        void writeRow(Image::row_const_access row);
+
+        /// write all rows of image, band of rows are filtered and compressed concurrently
+        /// if "threads" is greater than 1 (0 means number of hardware threads),
+        /// otherwise RGBA rows are passed to libpng in one call without copying
+        void writeImage(const ConstImageView& image, const unsigned threads);
+
+        /// finish file, all rows have to be written
+        void close();
+
+
+        /// returns true if palette have to be collected before writing
+        static bool usesPalette(const Image::PixelFormat format) {
+            return (format == Image::PF_PALETTE8 || format == Image::PF_AUTO);
+        }
+
+        /// append distinct colors of image missing in palette, returns false if there is more than "maxColors" colors
+        static bool collectPalette(const ConstImageView& image, std::vector<Image::Pixel>& palette, const std::size_t maxColors = 256);
+
+        /// append colors of image to palette of given format, if there is more than 256 colors
+        /// then std::invalid_argument is thrown for PF_PALETTE8 and palette is cleared for PF_AUTO
+        /// (image will be written as PF_RGBA32), returns false if collecting should stop
+        static bool collectPalette(const ConstImageView& image, std::vector<Image::Pixel>& palette, const Image::PixelFormat format);
+
+        /// PNG does not allow empty images, so 1x1 image of given color is written instead
+        static void writeEmpty(const std::string& path, const Image::Pixel& color, const Image::SaveOptions& options);
+
+        /// PNG does not allow empty images, so 1x1 image of given color is appended to "output" instead
+        static void writeEmpty(std::vector<uint8_t>& output, const Image::Pixel& color, const Image::SaveOptions& options);
+
+        /// create missing directories of file path
+        static void createParentDirectory(const std::string& path);
+
+
+    private:
+
+        void initialize(const Image::SaveOptions& options, const std::vector<Image::Pixel>& palette);
+
+        static void writeData(png_structp png, png_bytep data, png_size_t length);
+
+        static void flushData(png_structp png);
+
+        /// number of bytes in encoded row
+        std::size_t rowSize() const;
+
+        /// store row in pixel format of file in "out" (rowSize() bytes)
+        void convertRow(Image::row_const_access row, png_byte* out) const;
+
+        void release();
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_SRC_PNGWRITER_H_ */
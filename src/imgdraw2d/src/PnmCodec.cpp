@@ -0,0 +1,189 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "PnmCodec.h"
+
+#include <cstring>
+#include <cctype>
+
+
+namespace imgdraw2d {
+
+    /// reader of whitespace separated header tokens, comments are skipped
+    class PnmHeaderParser {
+
+        const uint8_t* data;
+        std::size_t size;
+        std::size_t pos;
+
+
+    public:
+
+        PnmHeaderParser(const uint8_t* data, const std::size_t size): data(data), size(size), pos(0) {
+        }
+
+        std::size_t position() const {
+            return pos;
+        }
+
+        /// returns empty string if there is no more tokens
+        std::string token() {
+            while (pos < size) {
+                if (data[pos] == '#') {
+                    while (pos < size && data[pos] != '\n')
+                        ++pos;
+                } else if (std::isspace( data[pos] )) {
+                    ++pos;
+                } else {
+                    break;
+                }
+            }
+            const std::size_t start = pos;
+            while (pos < size && std::isspace( data[pos] ) == false && data[pos] != '#')
+                ++pos;
+            return std::string( reinterpret_cast<const char*>( data + start ), pos - start );
+        }
+
+        bool number(uint32_t& value) {
+            const std::string item = token();
+            if (item.empty() || item.size() > 9 || item.find_first_not_of( "0123456789" ) != std::string::npos)
+                return false;
+            value = std::stoul( item );
+            return true;
+        }
+
+        /// skip single whitespace after header, returns false if there is none
+        bool endHeader() {
+            if (pos >= size || std::isspace( data[pos] ) == false)
+                return false;
+            ++pos;
+            return true;
+        }
+
+    };
+
+
+    /// ===============================================================================
+
+
+    bool PnmCodec::decode(const void* data, const std::size_t size, Image& image) const {
+        const uint8_t* bytes = static_cast<const uint8_t*>( data );
+        PnmHeaderParser parser( bytes, size );
+        const std::string magic = parser.token();
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t depth = 0;
+        uint32_t maxValue = 0;
+        if (magic == "P5" || magic == "P6") {
+            depth = (magic == "P5") ? 1 : 3;
+            if (parser.number( width ) == false || parser.number( height ) == false || parser.number( maxValue ) == false)
+                return false;
+            if (parser.endHeader() == false)
+                return false;
+        } else if (magic == "P7") {
+            while (true) {
+                const std::string key = parser.token();
+                if (key.empty())
+                    return false;
+                if (key == "ENDHDR")
+                    break;
+                if (key == "WIDTH") {
+                    if (parser.number( width ) == false)
+                        return false;
+                } else if (key == "HEIGHT") {
+                    if (parser.number( height ) == false)
+                        return false;
+                } else if (key == "DEPTH") {
+                    if (parser.number( depth ) == false)
+                        return false;
+                } else if (key == "MAXVAL") {
+                    if (parser.number( maxValue ) == false)
+                        return false;
+                } else if (key == "TUPLTYPE") {
+                    parser.token();                     /// layout is derived from depth
+                } else {
+                    return false;
+                }
+            }
+            if (parser.endHeader() == false)
+                return false;
+        } else {
+            return false;
+        }
+
+        if (maxValue != 255 || depth < 1 || depth > 4)
+            return false;
+        const std::size_t offset = parser.position();
+        if ((uint64_t) width * height * depth > size - offset)
+            return false;
+
+        prepare( image, width, height );
+        const uint8_t* in = bytes + offset;
+        for( uint32_t y=0; y<height; ++y ) {
+            Image::row_access row = image.row( y );
+            for( uint32_t x=0; x<width; ++x ) {
+                switch( depth ) {
+                case 1:     row[x] = Image::Pixel( in[0], in[0], in[0], 255 );      break;      /// GRAYSCALE
+                case 2:     row[x] = Image::Pixel( in[0], in[0], in[0], in[1] );    break;      /// GRAYSCALE_ALPHA
+                case 3:     row[x] = Image::Pixel( in[0], in[1], in[2], 255 );      break;      /// RGB
+                default:    row[x] = Image::Pixel( in[0], in[1], in[2], in[3] );    break;      /// RGB_ALPHA
+                }
+                in += depth;
+            }
+        }
+        return true;
+    }
+
+    void PnmCodec::encode(const Image& image, std::vector<uint8_t>& output, const Image::SaveOptions& /*options*/) const {
+        const uint32_t width = image.width();
+        const uint32_t height = image.height();
+        std::string header;
+        if (variant == PPM) {
+            header = "P6\n" + std::to_string( width ) + " " + std::to_string( height ) + "\n255\n";
+        } else {
+            header = "P7\nWIDTH " + std::to_string( width ) + "\nHEIGHT " + std::to_string( height ) + "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+        }
+
+        const std::size_t depth = (variant == PPM) ? 3 : 4;
+        output.resize( header.size() + (std::size_t) width * height * depth );
+        std::memcpy( output.data(), header.data(), header.size() );
+        uint8_t* out = output.data() + header.size();
+        for( uint32_t y=0; y<height; ++y ) {
+            Image::row_const_access row = image.row( y );
+            if (variant == PAM) {
+                /// layout of pixel is the same as in file
+                std::memcpy( out, row, width * depth );
+                out += width * depth;
+                continue ;
+            }
+            for( uint32_t x=0; x<width; ++x ) {
+                out[0] = row[x].red;
+                out[1] = row[x].green;
+                out[2] = row[x].blue;
+                out += 3;
+            }
+        }
+    }
+
+} /* namespace imgdraw2d */
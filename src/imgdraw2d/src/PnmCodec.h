@@ -0,0 +1,70 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#ifndef IMGDRAW2D_SRC_PNMCODEC_H_
+#define IMGDRAW2D_SRC_PNMCODEC_H_
+
+#include "imgdraw2d/ImageCodec.h"
+
+
+namespace imgdraw2d {
+
+    /**
+     * Binary Netpbm formats: PPM (P6) and PAM (P7).
+     *
+     * Pixels are stored without compression, so encoding is limited by memory bandwidth.
+     * Decoder accepts P5, P6 and P7 files with 8-bit samples regardless of variant.
+     */
+    class PnmCodec: public ImageCodec {
+    public:
+
+        enum Variant {
+            PPM,                    /// RGB, alpha is dropped
+            PAM                     /// RGBA
+        };
+
+
+    private:
+
+        Variant variant;
+
+
+    public:
+
+        PnmCodec(const Variant variant): variant(variant) {
+        }
+
+        std::string name() const override {
+            return (variant == PPM) ? "PPM" : "PAM";
+        }
+
+        bool decode(const void* data, const std::size_t size, Image& image) const override;
+
+        void encode(const Image& image, std::vector<uint8_t>& output, const Image::SaveOptions& options) const override;
+
+    };
+
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_SRC_PNMCODEC_H_ */
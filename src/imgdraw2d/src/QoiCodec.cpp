@@ -0,0 +1,232 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "QoiCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace imgdraw2d {
+
+    static const uint8_t OP_INDEX = 0x00;
+    static const uint8_t OP_DIFF  = 0x40;
+    static const uint8_t OP_LUMA  = 0x80;
+    static const uint8_t OP_RUN   = 0xC0;
+    static const uint8_t OP_RGB   = 0xFE;
+    static const uint8_t OP_RGBA  = 0xFF;
+    static const uint8_t OP_MASK  = 0xC0;
+
+    static const std::size_t HEADER_SIZE = 14;
+    static const uint8_t END_MARKER[] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    static const uint64_t MAX_PIXELS = 400000000;          /// limit of reference implementation
+
+
+    inline uint8_t colorHash(const Image::Pixel& pixel) {
+        return ( pixel.red * 3 + pixel.green * 5 + pixel.blue * 7 + pixel.alpha * 11 ) % 64;
+    }
+
+    inline void writeUint32(uint8_t* out, const uint32_t value) {
+        out[0] = value >> 24;
+        out[1] = value >> 16;
+        out[2] = value >> 8;
+        out[3] = value;
+    }
+
+    inline uint32_t readUint32(const uint8_t* in) {
+        return ( (uint32_t) in[0] << 24 ) | ( (uint32_t) in[1] << 16 ) | ( (uint32_t) in[2] << 8 ) | in[3];
+    }
+
+    /// check that chunks in range [HEADER_SIZE, end) are complete and cover "pixels",
+    /// pixel values are not decoded, so image can be left untouched on failure
+    static bool validStream(const uint8_t* bytes, const std::size_t end, const uint64_t pixels) {
+        std::size_t pos = HEADER_SIZE;
+        uint64_t count = 0;
+        while (count < pixels) {
+            if (pos >= end)
+                return false;
+            const uint8_t op = bytes[pos++];
+            if (op == OP_RGB) {
+                pos += 3;
+            } else if (op == OP_RGBA) {
+                pos += 4;
+            } else if ((op & OP_MASK) == OP_LUMA) {
+                pos += 1;
+            } else if ((op & OP_MASK) == OP_RUN) {
+                count += op & 0x3F;             /// current pixel is counted below
+            }
+            if (pos > end)
+                return false;
+            ++count;
+        }
+        return true;
+    }
+
+
+    /// ===============================================================================
+
+
+    bool QoiCodec::decode(const void* data, const std::size_t size, Image& image) const {
+        const uint8_t* bytes = static_cast<const uint8_t*>( data );
+        if (size < HEADER_SIZE + sizeof(END_MARKER) || std::memcmp( bytes, "qoif", 4 ) != 0)
+            return false;
+        const uint32_t width = readUint32( bytes + 4 );
+        const uint32_t height = readUint32( bytes + 8 );
+        const uint8_t channels = bytes[12];
+        if ((channels != 3 && channels != 4) || bytes[13] > 1)
+            return false;
+        if ((uint64_t) width * height > MAX_PIXELS)
+            return false;
+        const std::size_t end = size - sizeof(END_MARKER);
+        if (validStream( bytes, end, (uint64_t) width * height ) == false)
+            return false;
+
+        prepare( image, width, height );
+
+        Image::Pixel index[64];
+        std::fill( index, index + 64, Image::Pixel( 0, 0, 0, 0 ) );
+        Image::Pixel pixel( 0, 0, 0, 255 );
+        std::size_t pos = HEADER_SIZE;
+        uint32_t run = 0;
+        /// stream is validated, so chunks are read without bounds checks
+        for( uint32_t y=0; y<height; ++y ) {
+            Image::row_access row = image.row( y );
+            for( uint32_t x=0; x<width; ++x ) {
+                if (run > 0) {
+                    --run;
+                    row[x] = pixel;
+                    continue ;
+                }
+                const uint8_t op = bytes[pos++];
+                if (op == OP_RGB) {
+                    pixel.red   = bytes[pos];
+                    pixel.green = bytes[pos + 1];
+                    pixel.blue  = bytes[pos + 2];
+                    pos += 3;
+                } else if (op == OP_RGBA) {
+                    pixel.red   = bytes[pos];
+                    pixel.green = bytes[pos + 1];
+                    pixel.blue  = bytes[pos + 2];
+                    pixel.alpha = bytes[pos + 3];
+                    pos += 4;
+                } else if ((op & OP_MASK) == OP_INDEX) {
+                    pixel = index[ op ];
+                } else if ((op & OP_MASK) == OP_DIFF) {
+                    pixel.red   += ( (op >> 4) & 0x03 ) - 2;
+                    pixel.green += ( (op >> 2) & 0x03 ) - 2;
+                    pixel.blue  += (  op       & 0x03 ) - 2;
+                } else if ((op & OP_MASK) == OP_LUMA) {
+                    const uint8_t next = bytes[pos++];
+                    const int greenDiff = (op & 0x3F) - 32;
+                    pixel.red   += greenDiff - 8 + ( (next >> 4) & 0x0F );
+                    pixel.green += greenDiff;
+                    pixel.blue  += greenDiff - 8 + ( next & 0x0F );
+                } else {
+                    run = op & 0x3F;                    /// OP_RUN, current pixel included
+                }
+                index[ colorHash( pixel ) ] = pixel;
+                row[x] = pixel;
+            }
+        }
+        return true;
+    }
+
+    void QoiCodec::encode(const Image& image, std::vector<uint8_t>& output, const Image::SaveOptions& /*options*/) const {
+        const uint32_t width = image.width();
+        const uint32_t height = image.height();
+
+        /// worst case: every pixel as OP_RGBA
+        output.resize( HEADER_SIZE + (std::size_t) width * height * 5 + sizeof(END_MARKER) );
+        uint8_t* out = output.data();
+        std::memcpy( out, "qoif", 4 );
+        writeUint32( out + 4, width );
+        writeUint32( out + 8, height );
+        out[12] = 4;                                    /// RGBA
+        out[13] = 0;                                    /// sRGB with linear alpha
+        std::size_t pos = HEADER_SIZE;
+
+        Image::Pixel index[64];
+        std::fill( index, index + 64, Image::Pixel( 0, 0, 0, 0 ) );
+        Image::Pixel prev( 0, 0, 0, 255 );
+        uint32_t run = 0;
+        for( uint32_t y=0; y<height; ++y ) {
+            Image::row_const_access row = image.row( y );
+            for( uint32_t x=0; x<width; ++x ) {
+                const Image::Pixel& pixel = row[x];
+                if (pixel == prev) {
+                    ++run;
+                    if (run == 62) {
+                        out[pos++] = OP_RUN | (run - 1);
+                        run = 0;
+                    }
+                    continue ;
+                }
+                if (run > 0) {
+                    out[pos++] = OP_RUN | (run - 1);
+                    run = 0;
+                }
+
+                const uint8_t hash = colorHash( pixel );
+                if (index[ hash ] == pixel) {
+                    out[pos++] = OP_INDEX | hash;
+                } else {
+                    index[ hash ] = pixel;
+                    if (pixel.alpha == prev.alpha) {
+                        const int8_t redDiff   = pixel.red   - prev.red;
+                        const int8_t greenDiff = pixel.green - prev.green;
+                        const int8_t blueDiff  = pixel.blue  - prev.blue;
+                        const int redGreen  = redDiff  - greenDiff;
+                        const int blueGreen = blueDiff - greenDiff;
+                        if (redDiff > -3 && redDiff < 2 && greenDiff > -3 && greenDiff < 2 && blueDiff > -3 && blueDiff < 2) {
+                            out[pos++] = OP_DIFF | (redDiff + 2) << 4 | (greenDiff + 2) << 2 | (blueDiff + 2);
+                        } else if (redGreen > -9 && redGreen < 8 && greenDiff > -33 && greenDiff < 32 && blueGreen > -9 && blueGreen < 8) {
+                            out[pos++] = OP_LUMA | (greenDiff + 32);
+                            out[pos++] = (redGreen + 8) << 4 | (blueGreen + 8);
+                        } else {
+                            out[pos++] = OP_RGB;
+                            out[pos++] = pixel.red;
+                            out[pos++] = pixel.green;
+                            out[pos++] = pixel.blue;
+                        }
+                    } else {
+                        out[pos++] = OP_RGBA;
+                        out[pos++] = pixel.red;
+                        out[pos++] = pixel.green;
+                        out[pos++] = pixel.blue;
+                        out[pos++] = pixel.alpha;
+                    }
+                }
+                prev = pixel;
+            }
+        }
+        if (run > 0) {
+            out[pos++] = OP_RUN | (run - 1);
+        }
+
+        std::memcpy( out + pos, END_MARKER, sizeof(END_MARKER) );
+        pos += sizeof(END_MARKER);
+        output.resize( pos );
+    }
+
+} /* namespace imgdraw2d */
@@ -0,0 +1,92 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#ifndef IMGDRAW2D_SRC_RAWFORMAT_H_
+#define IMGDRAW2D_SRC_RAWFORMAT_H_
+
+#include "imgdraw2d/Image.h"
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace imgdraw2d {
+    namespace raw {
+
+        /// uncompressed image file: header followed by rows of pixels in native byte order
+        struct Header {
+            char magic[8];                  /// "IMG2DRAW"
+            uint32_t byteOrder;             /// ENDIAN_MARK written in native order of writer
+            uint32_t version;
+            uint32_t width;
+            uint32_t height;
+            uint32_t format;                /// Image::PixelFormat of stored pixels
+            uint32_t pixelSize;             /// number of bytes of pixel
+            uint64_t stride;                /// number of bytes between beginnings of consecutive rows
+            uint64_t dataOffset;            /// position of first row in file
+            uint8_t reserved[16];
+        };
+
+        static_assert( sizeof(Header) == 64, "unexpected raw header size" );
+
+        static const char MAGIC[8] = { 'I', 'M', 'G', '2', 'D', 'R', 'A', 'W' };
+        static const uint32_t ENDIAN_MARK = 0x01020304;
+        static const uint32_t VERSION = 1;
+
+
+        inline Header makeHeader(const uint32_t width, const uint32_t height, const std::size_t stride) {
+            Header header;
+            std::memset( &header, 0, sizeof(header) );
+            std::memcpy( header.magic, MAGIC, sizeof(MAGIC) );
+            header.byteOrder = ENDIAN_MARK;
+            header.version = VERSION;
+            header.width = width;
+            header.height = height;
+            header.format = Image::PF_RGBA32;
+            header.pixelSize = sizeof(Image::Pixel);
+            header.stride = stride * sizeof(Image::Pixel);
+            header.dataOffset = sizeof(Header);                 /// rows stay aligned when file is mapped
+            return header;
+        }
+
+        /// check if file of given size with given header can be read
+        inline bool validHeader(const Header& header, const uint64_t fileSize) {
+            if (std::memcmp( header.magic, MAGIC, sizeof(MAGIC) ) != 0)
+                return false;
+            if (header.byteOrder != ENDIAN_MARK || header.version != VERSION)
+                return false;
+            if (header.format != Image::PF_RGBA32 || header.pixelSize != sizeof(Image::Pixel))
+                return false;
+            if (header.stride % sizeof(Image::Pixel) != 0 || header.stride < (uint64_t) header.width * sizeof(Image::Pixel))
+                return false;
+            if (header.dataOffset < sizeof(Header) || header.dataOffset > fileSize)
+                return false;
+            if (header.height > 0 && header.stride > 0 && (fileSize - header.dataOffset) / header.stride < header.height)
+                return false;
+            return true;
+        }
+
+    }
+} /* namespace imgdraw2d */
+
+#endif /* IMGDRAW2D_SRC_RAWFORMAT_H_ */
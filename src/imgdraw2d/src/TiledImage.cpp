@@ -0,0 +1,166 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "imgdraw2d/TiledImage.h"
+
+#include "imgdraw2d/ImagePool.h"
+#include "PngWriter.h"
+
+
+namespace imgdraw2d {
+
+    TiledImage::TiledImage(const uint32_t tileSize, const Image::Pixel& background):
+            tileSide( std::max( tileSize, (uint32_t) 1 ) ),
+            backgroundColor( background ),
+            tiles(),
+            revisionCounter(0),
+            scratch(nullptr)
+    {
+    }
+
+    Image& TiledImage::tile(const int64_t column, const int64_t row) {
+        ++revisionCounter;
+        ImagePtr& item = tiles[ TileKey(row, column) ];
+        if (item == nullptr) {
+            item = ImagePool::global()->makeImage();
+            item->resize( tileSide, tileSide );
+            item->fill( backgroundColor );
+        }
+        return *item;
+    }
+
+    Image& TiledImage::acquireTile(const int64_t column, const int64_t row) {
+        TilesMap::iterator iter = tiles.find( TileKey(row, column) );
+        if (iter != tiles.end()) {
+            ++revisionCounter;
+            return *(iter->second);
+        }
+        if (scratch == nullptr) {
+            scratch = ImagePool::global()->makeImage();
+            scratch->resize( tileSide, tileSide );
+            scratch->fill( backgroundColor );
+        }
+        return *scratch;
+    }
+
+    void TiledImage::commitTile(const int64_t column, const int64_t row, const bool changed) {
+        if (scratch == nullptr || changed == false)
+            return ;
+        const TileKey key(row, column);
+        if (tiles.count( key ) > 0)
+            return ;
+        ++revisionCounter;
+        tiles[ key ] = std::move( scratch );
+    }
+
+    const Image* TiledImage::findTile(const int64_t column, const int64_t row) const {
+        TilesMap::const_iterator iter = tiles.find( TileKey(row, column) );
+        if (iter == tiles.end())
+            return nullptr;
+        return iter->second.get();
+    }
+
+    void TiledImage::flatten(const ImageView& target, const PointI& origin) const {
+        const int64_t w = target.width();
+        const int64_t h = target.height();
+        if (w < 1 || h < 1)
+            return ;
+
+        const RectI area( origin, origin + PointI(w - 1, h - 1) );
+        const RectI range = tileRange( area );
+        for( int64_t row = range.a.y; row <= range.b.y; ++row ) {
+            for( int64_t column = range.a.x; column <= range.b.x; ++column ) {
+                /// part of tile covered by target, in target coordinates
+                const PointI tilePos = tileOrigin( column, row ) - origin;
+                const int64_t sx = std::max( tilePos.x, (int64_t) 0 );
+                const int64_t sy = std::max( tilePos.y, (int64_t) 0 );
+                const int64_t ex = std::min( tilePos.x + tileSide, w );
+                const int64_t ey = std::min( tilePos.y + tileSide, h );
+
+                const Image* item = findTile( column, row );
+                if (item == nullptr) {
+                    target.fillRect( sx, sy, ex, ey, backgroundColor );
+                    continue ;
+                }
+                const ConstImageView source( *item, sx - tilePos.x, sy - tilePos.y, ex - sx, ey - sy );
+                target.pasteImage( sx, sy, source );
+            }
+        }
+    }
+
+    ImagePtr TiledImage::flatten(const RectI& area) const {
+        ImagePtr image = ImagePool::global()->makeImage();
+        image->resize( area.width() + 1, area.height() + 1 );
+        flatten( ImageView( *image ), area.a );
+        return image;
+    }
+
+    void TiledImage::save(const std::string& path, const RectI& area, const Image::SaveOptions& options) const {
+        PngWriter::createParentDirectory( path );
+
+        const int64_t w = area.width() + 1;
+        const int64_t h = area.height() + 1;
+        if (w < 1 || h < 1) {
+            PngWriter::writeEmpty( path, backgroundColor, options );
+            return ;
+        }
+
+        std::vector<Image::Pixel> palette;
+        if (PngWriter::usesPalette( options.format )) {
+            palette.push_back( backgroundColor );
+            for( TilesMap::const_iterator iter = tiles.begin(); iter != tiles.end(); ++iter ) {
+                const PointI tilePos = tileOrigin( iter->first.second, iter->first.first ) - area.a;
+                const int64_t sx = std::max( tilePos.x, (int64_t) 0 );
+                const int64_t sy = std::max( tilePos.y, (int64_t) 0 );
+                const int64_t ex = std::min( tilePos.x + tileSide, w );
+                const int64_t ey = std::min( tilePos.y + tileSide, h );
+                if (sx >= ex || sy >= ey)
+                    continue ;
+                const ConstImageView visible( *(iter->second), sx - tilePos.x, sy - tilePos.y, ex - sx, ey - sy );
+                if (PngWriter::collectPalette( visible, palette, options.format ) == false)
+                    break;
+            }
+        }
+
+        PngWriter writer( path, w, h, options, palette );
+        Image band( w, std::min( (int64_t) tileSide, h ) );
+        int64_t bandStart = area.a.y;
+        while (bandStart <= area.b.y) {
+            /// band ends at border of tiles row
+            const int64_t bandEnd = std::min( tileOrigin( 0, tileIndex( bandStart ) + 1 ).y, area.b.y + 1 );
+            const ImageView bandView = ImageView( band ).region( 0, 0, w, bandEnd - bandStart );
+            flatten( bandView, PointI( area.a.x, bandStart ) );
+            for( uint32_t y=0; y<bandView.height(); ++y ) {
+                writer.writeRow( bandView.row( y ) );
+            }
+            bandStart = bandEnd;
+        }
+        writer.close();
+    }
+
+    void TiledImage::clear() {
+        ++revisionCounter;
+        tiles.clear();
+    }
+
+} /* namespace imgdraw2d */
@@ -0,0 +1,103 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "imgdraw2d/AsyncImageWriter.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+
+using namespace imgdraw2d;
+
+
+BOOST_AUTO_TEST_SUITE( AsyncImageWriterSuite )
+
+    BOOST_AUTO_TEST_CASE( save_future ) {
+        std::vector< std::future<void> > results;
+        {
+            AsyncImageWriter writer( 2, 1 );
+            for (uint32_t i=0; i<4; ++i) {
+                ImagePtr image( new Image( 10 + i, 10 ) );
+                image->fill( Image::RED );
+                const std::string path = "async/save_" + std::to_string(i) + ".png";
+                results.push_back( writer.save( std::move(image), path ) );
+            }
+            writer.wait();
+            BOOST_CHECK_EQUAL( writer.pending(), 0 );
+        }
+        for (std::future<void>& item: results) {
+            BOOST_CHECK_NO_THROW( item.get() );
+        }
+        const Image loaded( "async/save_3.png" );
+        BOOST_CHECK_EQUAL( loaded.width(), 13 );
+        BOOST_CHECK( loaded.pixel(12, 9) == Image::RED );
+    }
+
+    BOOST_AUTO_TEST_CASE( save_error ) {
+        Image( 2, 2 ).save( "async/file.png" );
+
+        AsyncImageWriter writer( 1 );
+        std::future<void> result = writer.save( ImagePtr( new Image(2, 2) ), "async/file.png/image.png" );
+        BOOST_CHECK_THROW( result.get(), std::exception );
+    }
+
+    BOOST_AUTO_TEST_CASE( save_callback ) {
+        std::atomic<int> saved( 0 );
+        std::atomic<int> failed( 0 );
+        {
+            AsyncImageWriter writer( 3 );
+            const AsyncImageWriter::Callback callback = [&saved, &failed](const std::string& /*path*/, std::exception_ptr error) {
+                if (error == nullptr)
+                    ++saved;
+                else
+                    ++failed;
+            };
+            for (int i=0; i<6; ++i) {
+                const std::string path = "async/callback_" + std::to_string(i) + ".png";
+                writer.save( ImagePtr( new Image(5, 5) ), path, Image::SaveOptions::fast(), callback );
+            }
+        }
+        BOOST_CHECK_EQUAL( saved, 6 );
+        BOOST_CHECK_EQUAL( failed, 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( save_callback_throw ) {
+        std::atomic<int> called( 0 );
+        AsyncImageWriter writer( 1 );
+        const AsyncImageWriter::Callback callback = [&called](const std::string& /*path*/, std::exception_ptr /*error*/) {
+            ++called;
+            throw std::runtime_error( "callback failed" );
+        };
+        writer.save( ImagePtr( new Image(5, 5) ), "async/throw_0.png", Image::SaveOptions::fast(), callback );
+        writer.save( ImagePtr( new Image(5, 5) ), "async/throw_1.png", Image::SaveOptions::fast(), callback );
+        writer.wait();
+        BOOST_CHECK_EQUAL( called, 2 );
+        BOOST_CHECK_EQUAL( writer.pending(), 0 );
+
+        std::future<void> result = writer.save( ImagePtr( new Image(5, 5) ), "async/throw_2.png" );
+        BOOST_CHECK_NO_THROW( result.get() );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
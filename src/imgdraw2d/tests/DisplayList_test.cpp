@@ -0,0 +1,77 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "imgdraw2d/DisplayList.h"
+
+#include "ImgTestUtils.h"
+
+
+using namespace imgdraw2d;
+
+
+BOOST_AUTO_TEST_SUITE( DisplayListSuite )
+
+    BOOST_AUTO_TEST_CASE( record ) {
+        DisplayList commands;
+        Painter painter( commands );
+        painter.fillCircle( PointI(-5, 3), 4, "red" );
+        painter.fillRect( PointI(10, -2), 3, 5, "green" );
+
+        BOOST_CHECK_EQUAL( commands.size(), 2 );
+        BOOST_CHECK( commands.area() == RectI( -9, -2, 12, 7 ) );
+
+        commands.clear();
+        BOOST_CHECK( commands.empty() );
+    }
+
+    BOOST_AUTO_TEST_CASE( render_bands ) {
+        Image image( 100, 80 );
+        image.fill( Image::WHITE );
+        Painter painter( image );
+        DisplayList commands;
+        Painter recorder( commands );
+
+        /// canvas origin is in the middle of image
+        const PointI origin( 37, 29 );
+        for (Painter* item: { &painter, &recorder }) {
+            const PointI offset = (item == &painter) ? PointI(0, 0) : origin;
+            item->drawLine( PointI(3, 5) - offset, PointI(90, 70) - offset, 5, "blue" );
+            item->fillCircle( PointI(40, 30) - offset, 20, "red" );
+            item->drawRing( PointI(60, 40) - offset, 25, 3, "green" );
+            item->setCompositionMode( Painter::CM_DIFFERENCE );
+            item->fillRect( PointI(20, 20) - offset, 50, 30, "blue" );
+            item->setCompositionMode( Painter::CM_DESTINATION );
+            item->drawArc( PointI(30, 50) - offset, 20, 4, 0.5, 4.0, "orange" );
+            item->fillRect( PointI(70, 2) - offset, 20, 30, "black" );
+        }
+
+        const RectI area( -origin, -origin + PointI(99, 79) );
+        commands.save( "displaylist/render_bands.png", area, Image::WHITE, Image::PF_RGBA32, 7 );
+        IMAGES_COMPARE( Image( "displaylist/render_bands.png" ), image, "displaylist" );
+
+        commands.save( "displaylist/render_bands_palette.png", area, Image::WHITE, Image::PF_PALETTE8, 16 );
+        IMAGES_COMPARE( Image( "displaylist/render_bands_palette.png" ), image, "displaylist" );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
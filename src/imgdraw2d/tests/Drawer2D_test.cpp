@@ -25,6 +25,7 @@
 
 #include "ImgTestUtils.h"
 #include <chrono>
+#include <cmath>
 
 
 using namespace imgdraw2d;
@@ -426,6 +427,176 @@ BOOST_AUTO_TEST_SUITE( Drawer2DSuite )
         CHECK_IMAGE( image );
     }
 
+    BOOST_AUTO_TEST_CASE( expand_growth ) {
+        Drawer2DD drawer;
+        drawer.setDrawColor( "green" );
+        drawer.fillCircle( PointD{-5.0, -5.0}, 1.0 );
+        drawer.setDrawColor( "red" );
+        drawer.fillCircle( PointD{ 5.0,  5.0}, 1.0 );
+
+        Drawer2DD growDrawer;
+        growDrawer.setGrowthFactor( 2.0 );
+        growDrawer.setDrawColor( "green" );
+        growDrawer.fillCircle( PointD{-5.0, -5.0}, 1.0 );
+        growDrawer.setDrawColor( "red" );
+        growDrawer.fillCircle( PointD{ 5.0,  5.0}, 1.0 );
+
+        IMAGES_COMPARE( growDrawer.image(), drawer.image(), "drawer2d" );
+    }
+
+    BOOST_AUTO_TEST_CASE( expand_growth_fractional ) {
+        for (const double scale: { 1.0, 7.3, 20.0 }) {
+            Drawer2DD drawer( scale );
+            drawer.setBackground("white");
+            drawer.setGrowthFactor( 1.05 );
+            Drawer2DD growDrawer( scale );
+            growDrawer.setBackground("white");
+            growDrawer.setGrowthFactor( 1.7 );
+            for (Drawer2DD* item: { &drawer, &growDrawer }) {
+                item->setDrawColor( "green" );
+                item->fillCircle( PointD(-2.33, 1.71), 1.27 );
+                growDrawer.image();                                 /// reading image does not affect drawing
+                item->setDrawColor( "red" );
+                item->fillCircle( PointD(4.61, -3.19), 0.83 );
+                item->setDrawColor( "blue" );
+                item->drawLine( PointD(-1.13, -2.77), PointD(5.29, 3.41), 0.35 );
+                growDrawer.image();
+                item->drawRing( PointD(0.37, 6.51), 2.13, 0.3 );
+            }
+
+            IMAGES_COMPARE( growDrawer.image(), drawer.image(), "drawer2d" );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( expand_growth_image ) {
+        Drawer2DD drawer;
+        drawer.setBackground("white");
+        drawer.setGrowthFactor( 2.0 );
+        drawer.fillCircle( PointD{0.0, 0.0}, 1.0 );
+        drawer.fillCircle( PointD{2.0, 0.0}, 1.0 );
+
+        const Image* canvas = &drawer.imgBox.canvas();
+        const uint32_t canvasWidth = canvas->width();
+        BOOST_CHECK_EQUAL( drawer.image().width(), 50 );
+        BOOST_CHECK( canvasWidth > 50 );
+        BOOST_CHECK_EQUAL( drawer.imgBox.canvas().width(), canvasWidth );
+
+        /// reserved space is still used
+        drawer.fillCircle( PointD{3.0, 0.0}, 1.0 );
+        BOOST_CHECK( &drawer.imgBox.canvas() == canvas );
+        BOOST_CHECK_EQUAL( drawer.image().width(), 60 );
+    }
+
+    BOOST_AUTO_TEST_CASE( expand_growth_path ) {
+        Drawer2DD drawer;
+        drawer.setBackground("white");
+        Drawer2DD growDrawer;
+        growDrawer.setBackground("white");
+        growDrawer.setGrowthFactor( 1.5 );
+        for (int i=0; i<20; ++i) {
+            const PointD from( i, -i % 2 );
+            const PointD to( i + 1, -(i + 1) % 2 );
+            drawer.drawLine( from, to, 0.5 );
+            growDrawer.drawLine( from, to, 0.5 );
+        }
+
+        IMAGES_COMPARE( growDrawer.image(), drawer.image(), "drawer2d" );
+    }
+
+    BOOST_AUTO_TEST_CASE( tiled_expand ) {
+        Drawer2DD drawer;
+        drawer.setBackground("white");
+        Drawer2DD tiledDrawer;
+        tiledDrawer.setTiled( true, 16 );
+        tiledDrawer.setBackground("white");
+        for (Drawer2DD* item: { &drawer, &tiledDrawer }) {
+            item->setDrawColor( "blue" );
+            item->drawLine( PointD(0.0, 0.0), PointD(4.0, 3.0), 0.4 );
+            item->setDrawColor( "green" );
+            item->fillCircle( PointD(-5.0, -5.0), 1.0 );
+            item->setDrawColor( "red" );
+            item->drawRing( PointD(6.0, -3.0), 2.0, 0.4 );
+        }
+
+        IMAGES_COMPARE( tiledDrawer.image(), drawer.image(), "drawer2d" );
+
+        tiledDrawer.save( "drawer2d/tiled_expand.png" );
+        IMAGES_COMPARE( Image( "drawer2d/tiled_expand.png" ), drawer.image(), "drawer2d" );
+
+        ImagePtr image = tiledDrawer.takeImage();
+        IMAGES_COMPARE( *image, drawer.image(), "drawer2d" );
+        BOOST_CHECK( tiledDrawer.image().empty() );
+    }
+
+    BOOST_AUTO_TEST_CASE( tiled_expand_fractional ) {
+        for (const double scale: { 1.0, 7.3, 20.0 }) {
+            Drawer2DD drawer( scale );
+            drawer.setBackground("white");
+            drawer.setGrowthFactor( 1.3 );                          /// dense canvas on anchored grid
+            Drawer2DD tiledDrawer( scale );
+            tiledDrawer.setTiled( true, 16 );
+            tiledDrawer.setBackground("white");
+            for (Drawer2DD* item: { &drawer, &tiledDrawer }) {
+                for (int i = 0; i < 12; ++i) {
+                    item->setDrawColor( (i % 2 == 0) ? "blue" : "red" );
+                    item->fillRect( PointD(i * 1.37 - 3.1, std::sin(i) * 4.3 + 0.23), 1.3 + i * 0.11, 0.7 + i * 0.05, i * 0.4 );
+                }
+                item->setDrawColor( "green" );
+                item->fillCircle( PointD(-2.33, 1.71), 1.27 );
+                item->drawLine( PointD(-1.13, -2.77), PointD(5.29, 3.41), 0.35 );
+            }
+
+            IMAGES_COMPARE( tiledDrawer.image(), drawer.image(), "drawer2d" );
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE( streaming_expand ) {
+        Drawer2DD drawer;
+        drawer.setBackground("white");
+        Drawer2DD streamDrawer;
+        streamDrawer.setStreaming( true, 7 );
+        streamDrawer.setBackground("white");
+        for (Drawer2DD* item: { &drawer, &streamDrawer }) {
+            item->setDrawColor( "blue" );
+            item->drawLine( PointD(0.0, 0.0), PointD(4.0, 3.0), 0.4 );
+            item->setDrawColor( "green" );
+            item->fillCircle( PointD(-5.0, -5.0), 1.0 );
+            item->setDrawColor( "red" );
+            item->drawRing( PointD(6.0, -3.0), 2.0, 0.4 );
+        }
+        BOOST_CHECK_EQUAL( streamDrawer.image().width(), drawer.image().width() );
+
+        streamDrawer.save( "drawer2d/streaming_expand.png" );
+        IMAGES_COMPARE( Image( "drawer2d/streaming_expand.png" ), drawer.image(), "drawer2d" );
+
+        IMAGES_COMPARE( streamDrawer.image(), drawer.image(), "drawer2d" );
+    }
+
+    BOOST_AUTO_TEST_CASE( streaming_expand_fractional ) {
+        for (const double scale: { 1.0, 7.3, 20.0 }) {
+            Drawer2DD drawer( scale );
+            drawer.setBackground("white");
+            drawer.setGrowthFactor( 1.3 );                          /// dense canvas on anchored grid
+            Drawer2DD streamDrawer( scale );
+            streamDrawer.setStreaming( true, 7 );
+            streamDrawer.setBackground("white");
+            for (Drawer2DD* item: { &drawer, &streamDrawer }) {
+                for (int i = 0; i < 12; ++i) {
+                    item->setDrawColor( (i % 2 == 0) ? "blue" : "red" );
+                    item->fillRect( PointD(i * 1.37 - 3.1, std::sin(i) * 4.3 + 0.23), 1.3 + i * 0.11, 0.7 + i * 0.05, i * 0.4 );
+                }
+                item->setDrawColor( "green" );
+                item->fillCircle( PointD(4.61, -3.19), 0.83 );
+                item->drawRing( PointD(0.37, 6.51), 2.13, 0.3 );
+            }
+
+            streamDrawer.save( "drawer2d/streaming_expand_fractional.png" );
+            IMAGES_COMPARE( Image( "drawer2d/streaming_expand_fractional.png" ), drawer.image(), "drawer2d" );
+
+            IMAGES_COMPARE( streamDrawer.image(), drawer.image(), "drawer2d" );
+        }
+    }
+
     BOOST_AUTO_TEST_CASE( example ) {
         Drawer2DD drawer(20.0);
         drawer.setDrawColor( "red" );
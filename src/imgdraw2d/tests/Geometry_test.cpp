@@ -56,6 +56,17 @@ BOOST_AUTO_TEST_SUITE( GeometrySuite )
         BOOST_CHECK_CLOSE( angle, 90.0, 1.0 );
     }
 
+    BOOST_AUTO_TEST_CASE( floorDiv_ceilDiv ) {
+        BOOST_CHECK_EQUAL( floorDiv( 7, 2 ), 3 );
+        BOOST_CHECK_EQUAL( floorDiv( -7, 2 ), -4 );
+        BOOST_CHECK_EQUAL( floorDiv( 7, -2 ), -4 );
+        BOOST_CHECK_EQUAL( floorDiv( -6, 2 ), -3 );
+        BOOST_CHECK_EQUAL( ceilDiv( 7, 2 ), 4 );
+        BOOST_CHECK_EQUAL( ceilDiv( -7, 2 ), -3 );
+        BOOST_CHECK_EQUAL( ceilDiv( -7, -2 ), 4 );
+        BOOST_CHECK_EQUAL( ceilDiv( 6, -2 ), -3 );
+    }
+
     BOOST_AUTO_TEST_CASE( normalizeAngle_positive ) {
         const double angle = normalizeAngle( M_PI_2 * 15 );
         BOOST_CHECK_CLOSE( angle, 3 * M_PI_2, 1.0 );
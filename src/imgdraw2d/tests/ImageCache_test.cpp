@@ -0,0 +1,92 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+
+#include "imgdraw2d/ImageCache.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace imgdraw2d;
+
+
+BOOST_AUTO_TEST_SUITE( ImageCacheSuite )
+
+    BOOST_AUTO_TEST_CASE( load_cached ) {
+        Image image( 10, 10 );
+        image.fill( Image::RED );
+        image.save( "imagecache/load_cached.png" );
+
+        std::shared_ptr<ImageCache> cache = ImageCache::make();
+        ImageCache::ImageConstPtr first = cache->load( "imagecache/load_cached.png" );
+        BOOST_REQUIRE( first != nullptr );
+        BOOST_CHECK( *first == image );
+        BOOST_CHECK_EQUAL( cache->count(), 1 );
+
+        ImageCache::ImageConstPtr second = cache->load( "imagecache/load_cached.png" );
+        BOOST_CHECK_EQUAL( first.get(), second.get() );
+
+        /// file changed
+        Image changed( 12, 10 );
+        changed.fill( Image::BLUE );
+        changed.save( "imagecache/load_cached.png" );
+        ImageCache::ImageConstPtr third = cache->load( "imagecache/load_cached.png" );
+        BOOST_REQUIRE( third != nullptr );
+        BOOST_CHECK( *third == changed );
+        BOOST_CHECK( *first == image );
+        BOOST_CHECK_EQUAL( cache->count(), 1 );
+    }
+
+    BOOST_AUTO_TEST_CASE( missing_file ) {
+        std::shared_ptr<ImageCache> cache = ImageCache::make();
+        BOOST_CHECK( cache->load( "imagecache/missing.png" ) == nullptr );
+        BOOST_CHECK_EQUAL( cache->count(), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( lru_eviction ) {
+        Image image( 16, 16 );
+        image.fill( Image::GREEN );
+        image.save( "imagecache/lru_a.png" );
+        image.save( "imagecache/lru_b.png" );
+        image.save( "imagecache/lru_c.png" );
+
+        std::shared_ptr<ImageCache> cache = ImageCache::make();
+        ImageCache::ImageConstPtr imageA = cache->load( "imagecache/lru_a.png" );
+        const std::size_t imageSize = cache->size();
+        BOOST_CHECK( imageSize >= 16 * 16 * 4 );
+        cache->setCapacity( imageSize * 2 );
+
+        cache->load( "imagecache/lru_b.png" );
+        BOOST_CHECK_EQUAL( cache->load( "imagecache/lru_a.png" ).get(), imageA.get() );        /// "a" is most recent
+        cache->load( "imagecache/lru_c.png" );                                                  /// "b" is removed
+        BOOST_CHECK_EQUAL( cache->count(), 2 );
+        BOOST_CHECK_EQUAL( cache->size(), imageSize * 2 );
+        BOOST_CHECK_EQUAL( cache->load( "imagecache/lru_a.png" ).get(), imageA.get() );
+
+        cache->setCapacity( 0 );
+        BOOST_CHECK_EQUAL( cache->count(), 0 );
+        BOOST_CHECK( *imageA == image );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
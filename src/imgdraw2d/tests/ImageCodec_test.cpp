@@ -0,0 +1,140 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "imgdraw2d/ImageCodec.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+
+
+using namespace imgdraw2d;
+
+
+static Image testImage() {
+    Image image( 67, 41 );
+    image.fill( Image::WHITE );
+    image.fillRect( 5, 5, 40, 30, Image::RED );
+    image.fillRect( 30, 20, 60, 40, Image::Pixel(10, 200, 30, 128) );
+    for( uint32_t x=0; x<image.width(); ++x ) {
+        image.setPixel( x, 0, Image::Pixel(x * 3, x * 5, x * 7, 255 - x) );      /// gradient and noise
+        image.setPixel( x, 1, Image::Pixel(x * 37, x * 101, x * 59, 255) );
+    }
+    return image;
+}
+
+
+BOOST_AUTO_TEST_SUITE( ImageCodecSuite )
+
+    BOOST_AUTO_TEST_CASE( find ) {
+        BOOST_CHECK( ImageCodec::find( "image.qoi" ) == ImageCodec::qoi() );
+        BOOST_CHECK( ImageCodec::find( "dir.x/IMAGE.QOI" ) == ImageCodec::qoi() );
+        BOOST_CHECK( ImageCodec::find( "image.ppm" ) == ImageCodec::ppm() );
+        BOOST_CHECK( ImageCodec::find( "image.pam" ) == ImageCodec::pam() );
+        BOOST_CHECK( ImageCodec::find( "image.png" ) == ImageCodec::png() );
+        BOOST_CHECK( ImageCodec::find( "image.unknown" ) == ImageCodec::png() );
+        BOOST_CHECK( ImageCodec::find( "image" ) == ImageCodec::png() );
+    }
+
+    BOOST_AUTO_TEST_CASE( qoi ) {
+        Image image = testImage();
+        image.save( "imagecodec/image.qoi" );
+
+        Image loaded;
+        BOOST_CHECK( loaded.load( "imagecodec/image.qoi" ) );
+        BOOST_CHECK( loaded == image );
+
+        std::vector<uint8_t> stream;
+        ImageCodec::qoi()->encode( image, stream, Image::SaveOptions() );
+        BOOST_CHECK( stream.size() < image.width() * image.height() );
+        BOOST_CHECK( ImageCodec::qoi()->decode( stream.data(), stream.size() - 20, loaded ) == false );
+    }
+
+    BOOST_AUTO_TEST_CASE( decode_truncated ) {
+        const Image image = testImage();
+        Image target( 3, 2 );
+        target.fill( Image::RED );
+        const Image original = target;
+
+        std::vector<uint8_t> stream;
+        ImageCodec::qoi()->encode( image, stream, Image::SaveOptions() );
+        BOOST_CHECK( ImageCodec::qoi()->decode( stream.data(), stream.size() - 20, target ) == false );
+        BOOST_CHECK( target == original );
+
+        ImageCodec::pam()->encode( image, stream, Image::SaveOptions() );
+        BOOST_CHECK( ImageCodec::pam()->decode( stream.data(), stream.size() - 1, target ) == false );
+        BOOST_CHECK( target == original );
+
+        const std::string gray = "P5\n2 2\n255\n\x10\x20";
+        BOOST_CHECK( ImageCodec::ppm()->decode( gray.data(), gray.size(), target ) == false );
+        BOOST_CHECK( target == original );
+    }
+
+    BOOST_AUTO_TEST_CASE( decode_truncated_png ) {
+        const Image image = testImage();
+        Image target( image.width(), image.height() );
+        target.fill( Image::RED );
+        const Image original = target;
+
+        std::vector<uint8_t> stream;
+        image.encodePng( stream );
+        stream.resize( stream.size() / 2 );
+        BOOST_CHECK( ImageCodec::png()->decode( stream.data(), stream.size(), target ) == false );
+        BOOST_CHECK( target == original );
+
+        std::ofstream file( "imagecodec/truncated.png", std::ios::binary );
+        file.write( reinterpret_cast<const char*>( stream.data() ), stream.size() );
+        file.close();
+        BOOST_CHECK( target.load( "imagecodec/truncated.png" ) == false );
+        BOOST_CHECK( target == original );
+    }
+
+    BOOST_AUTO_TEST_CASE( pnm ) {
+        Image image = testImage();
+        image.save( "imagecodec/image.pam" );
+        BOOST_CHECK( Image( "imagecodec/image.pam" ) == image );
+
+        image.save( "imagecodec/image.ppm" );
+        const Image loaded( "imagecodec/image.ppm" );
+        BOOST_CHECK( loaded.pixel( 10, 10 ) == Image::RED );
+        BOOST_CHECK( loaded.pixel( 50, 30 ) == Image::Pixel(10, 200, 30, 255) );        /// alpha is dropped
+
+        const std::string gray = "P5\n# comment\n2 1\n255\n\x10\x20";
+        Image grayImage;
+        BOOST_CHECK( ImageCodec::ppm()->decode( gray.data(), gray.size(), grayImage ) );
+        BOOST_CHECK( grayImage.pixel( 1, 0 ) == Image::Pixel(32, 32, 32, 255) );
+    }
+
+    BOOST_AUTO_TEST_CASE( registerCodec ) {
+        ImageCodec::registerCodec( "qoiz", ImageCodec::qoi() );
+        Image image = testImage();
+        image.save( "imagecodec/image.qoiz" );
+        Image loaded;
+        BOOST_CHECK( ImageCodec::qoi()->decode( "qoif", 4, loaded ) == false );
+        BOOST_CHECK( loaded.load( "imagecodec/image.qoiz" ) );
+        BOOST_CHECK( loaded == image );
+        BOOST_CHECK( loaded.load( "imagecodec/image.qoi.missing" ) == false );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "imgdraw2d/ImagePool.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace imgdraw2d;
+
+
+BOOST_AUTO_TEST_SUITE( ImagePoolSuite )
+
+    BOOST_AUTO_TEST_CASE( sizeClass ) {
+        BOOST_CHECK_EQUAL( ImagePool::sizeClass(     1 ),  4096 );
+        BOOST_CHECK_EQUAL( ImagePool::sizeClass(  4096 ),  4096 );
+        BOOST_CHECK_EQUAL( ImagePool::sizeClass(  4097 ),  5120 );
+        BOOST_CHECK_EQUAL( ImagePool::sizeClass( 16384 ), 16384 );
+        BOOST_CHECK_EQUAL( ImagePool::sizeClass( 16385 ), 20480 );
+    }
+
+    BOOST_AUTO_TEST_CASE( reuse_buffer ) {
+        std::shared_ptr<ImagePool> pool = ImagePool::make();
+        const Image::Pixel* data = nullptr;
+        {
+            ImagePtr image = pool->makeImage(100, 100);
+            data = image->data();
+        }
+        BOOST_CHECK( pool->size() > 0 );
+
+        ImagePtr image = pool->makeImage(99, 101);
+        BOOST_CHECK_EQUAL( image->data(), data );
+        BOOST_CHECK_EQUAL( pool->size(), 0 );
+        BOOST_CHECK( image->pixel(98, 100) == Image::TRANSPARENT );
+    }
+
+    BOOST_AUTO_TEST_CASE( capacity ) {
+        std::shared_ptr<ImagePool> pool = ImagePool::make( 50000 );
+        {
+            ImagePtr imageA = pool->makeImage(100, 100);
+            ImagePtr imageB = pool->makeImage(10, 10);
+        }
+        BOOST_CHECK_EQUAL( pool->size(), 4096 );
+
+        pool->setCapacity( 0 );
+        BOOST_CHECK_EQUAL( pool->size(), 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( pool_destroyed ) {
+        ImagePtr image;
+        {
+            std::shared_ptr<ImagePool> pool = ImagePool::make();
+            image = pool->makeImage(10, 10);
+        }
+        image->resize(20, 20);
+        image->fill( Image::RED );
+        BOOST_CHECK( image->pixel(19, 19) == Image::RED );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+
+#include "imgdraw2d/ImageView.h"
+
+#include "imgdraw2d/Painter.h"
+
+#include <boost/test/unit_test.hpp>
+
+
+using namespace imgdraw2d;
+
+
+BOOST_AUTO_TEST_SUITE( ImageViewSuite )
+
+    BOOST_AUTO_TEST_CASE( region_clip ) {
+        Image image(10, 8);
+        const ImageView view( image, 6, 5, 10, 10 );
+        BOOST_CHECK_EQUAL( view.width(), 4 );
+        BOOST_CHECK_EQUAL( view.height(), 3 );
+        BOOST_CHECK_EQUAL( view.stride(), image.stride() );
+        BOOST_CHECK_EQUAL( view.data(), &image.pixel(6, 5) );
+    }
+
+    BOOST_AUTO_TEST_CASE( region_outside ) {
+        Image image(10, 8);
+        const ImageView view( image, 10, 2, 3, 3 );
+        BOOST_CHECK_EQUAL( view.empty(), true );
+    }
+
+    BOOST_AUTO_TEST_CASE( fill_region ) {
+        Image image(10, 8);
+        image.fill( Image::WHITE );
+        const ImageView view( image, 2, 3, 4, 2 );
+        view.fill( Image::RED );
+        BOOST_CHECK( image.pixel(1, 3) == Image::WHITE );
+        BOOST_CHECK( image.pixel(2, 3) == Image::RED );
+        BOOST_CHECK( image.pixel(5, 4) == Image::RED );
+        BOOST_CHECK( image.pixel(6, 4) == Image::WHITE );
+        BOOST_CHECK( image.pixel(5, 5) == Image::WHITE );
+    }
+
+    BOOST_AUTO_TEST_CASE( external_buffer ) {
+        Image::Pixel buffer[ 3 * 4 ];
+        const ImageView view( buffer, 2, 3, 4 );
+        view.fill( Image::BLUE );
+        view.pixel(1, 2) = Image::RED;
+        BOOST_CHECK( buffer[0] == Image::BLUE );
+        BOOST_CHECK( buffer[9] == Image::RED );
+
+        Image image(2, 3);
+        image.fill( Image::BLUE );
+        image.setPixel(1, 2, Image::RED);
+        BOOST_CHECK( ConstImageView(image).equals( view ) );
+    }
+
+    BOOST_AUTO_TEST_CASE( equals_region ) {
+        Image image(20, 20);
+        image.fill( Image::WHITE );
+        image.fillRect(0, 0, 5, 5, Image::RED);
+        image.fillRect(10, 10, 15, 15, Image::RED);
+        const ConstImageView viewA( image, 0, 0, 6, 6 );
+        const ConstImageView viewB( image, 10, 10, 6, 6 );
+        BOOST_CHECK( viewA.equals( viewB ) );
+        const ConstImageView viewC( image, 1, 0, 6, 6 );
+        BOOST_CHECK( viewA.equals( viewC ) == false );
+    }
+
+    BOOST_AUTO_TEST_CASE( paint_region ) {
+        Image image(30, 30);
+        image.fill( Image::WHITE );
+        Painter painter( ImageView( image, 10, 10, 10, 10 ) );
+        painter.fillCircle( 5, 5, 20, Image::RED );
+        BOOST_CHECK( image.pixel( 9, 15) == Image::WHITE );
+        BOOST_CHECK( image.pixel(10, 15) == Image::RED );
+        BOOST_CHECK( image.pixel(19, 19) == Image::RED );
+        BOOST_CHECK( image.pixel(20, 19) == Image::WHITE );
+        BOOST_CHECK( image.pixel(15, 20) == Image::WHITE );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
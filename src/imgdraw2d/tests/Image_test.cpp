@@ -22,8 +22,11 @@
 ///
 
 #include "imgdraw2d/Image.h"
+#include "imgdraw2d/ImagePool.h"
+#include "imgdraw2d/ImageView.h"
 
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
 
 
 using namespace imgdraw2d;
@@ -132,6 +135,181 @@ BOOST_AUTO_TEST_SUITE( ImageSuite )
         BOOST_CHECK_EQUAL(pix.alpha, 255);
     }
 
+    BOOST_AUTO_TEST_CASE( save_formats ) {
+        Image object(10, 10);
+        object.fill( Image::TRANSPARENT );
+        object.fillRect(0, 0, 5, 10, Image::RED);
+        object.fillRect(5, 0, 10, 5, Image::WHITE);
+
+        object.save( "save_palette.png", Image::PF_PALETTE8 );
+        BOOST_CHECK( Image( "save_palette.png" ) == object );
+
+        object.save( "save_rgb.png", Image::PF_RGB24 );
+        const Image rgb( "save_rgb.png" );
+        BOOST_CHECK( rgb.pixel(1, 1) == Image::RED );
+        BOOST_CHECK( rgb.pixel(9, 9) == Image::BLACK );
+
+        object.save( "save_gray.png", Image::PF_GRAY_ALPHA );
+        const Image gray( "save_gray.png" );
+        BOOST_CHECK( gray.pixel(1, 1) == Image::Pixel(76, 76, 76, 255) );
+        BOOST_CHECK( gray.pixel(9, 1) == Image::WHITE );
+        BOOST_CHECK_EQUAL( gray.pixel(9, 9).alpha, 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( save_options ) {
+        Image object(64, 64);
+        object.fill( Image::WHITE );
+        object.fillRect(10, 10, 50, 30, Image::BLUE);
+
+        object.save( "save_fast.png", Image::SaveOptions::fast() );
+        BOOST_CHECK( Image( "save_fast.png" ) == object );
+
+        object.save( "save_compact.png", Image::SaveOptions::compact( Image::PF_PALETTE8 ) );
+        BOOST_CHECK( Image( "save_compact.png" ) == object );
+
+        Image::SaveOptions stored;
+        stored.compressionLevel = 0;
+        object.save( "save_stored.png", stored );
+        BOOST_CHECK( Image( "save_stored.png" ) == object );
+        BOOST_CHECK( boost::filesystem::file_size( "save_stored.png" ) > 64 * 64 * 4 );
+        BOOST_CHECK( boost::filesystem::file_size( "save_fast.png" ) < 64 * 64 );
+    }
+
+    BOOST_AUTO_TEST_CASE( encode_decode ) {
+        Image object(20, 10);
+        object.fill( Image::TRANSPARENT );
+        object.fillRect(0, 0, 5, 10, Image::RED);
+        object.fillRect(5, 0, 20, 5, Image::WHITE);
+
+        std::vector<uint8_t> stream;
+        object.encodePng( stream );
+        Image decoded;
+        BOOST_CHECK( decoded.decodePng( stream.data(), stream.size() ) );
+        BOOST_CHECK( decoded == object );
+
+        /// encoded stream is the same as saved file
+        object.save( "encode_decode.png" );
+        BOOST_CHECK_EQUAL( boost::filesystem::file_size( "encode_decode.png" ), stream.size() );
+
+        object.encodePng( stream, Image::PF_PALETTE8 );
+        BOOST_CHECK( decoded.decodePng( stream.data(), stream.size() ) );
+        BOOST_CHECK( decoded == object );
+
+        object.encodePng( stream, Image::PF_GRAY8 );
+        BOOST_CHECK( decoded.decodePng( stream.data(), stream.size() ) );
+        BOOST_CHECK( decoded.pixel(1, 1) == Image::Pixel(76, 76, 76, 255) );
+    }
+
+    BOOST_AUTO_TEST_CASE( load_pooled ) {
+        Image frameA(30, 20);
+        frameA.fill( Image::RED );
+        frameA.save( "load_frame_a.png", Image::PF_RGB24 );
+        Image frameB(30, 20);
+        frameB.fill( Image::TRANSPARENT );
+        frameB.fillRect(5, 5, 10, 10, Image::BLUE);
+        frameB.save( "load_frame_b.png", Image::PF_PALETTE8 );
+
+        std::shared_ptr<ImagePool> pool = ImagePool::make();
+        ImagePtr pooled = pool->makeImage( 30, 20 );
+        Image& object = *pooled;
+        const Image::Pixel* data = object.data();
+        BOOST_CHECK( object.load( "load_frame_a.png" ) );
+        BOOST_CHECK( object == frameA );
+        BOOST_CHECK( object.load( "load_frame_b.png" ) );
+        BOOST_CHECK( object == frameB );
+        /// buffers are swapped through pool, first buffer is reused by second load
+        BOOST_CHECK_EQUAL( object.data(), data );
+
+        BOOST_CHECK( object.load( "load_missing.png" ) == false );
+    }
+
+    BOOST_AUTO_TEST_CASE( decode_invalid ) {
+        Image object(4, 4);
+        object.fill( Image::RED );
+        std::vector<uint8_t> stream;
+        object.encodePng( stream );
+
+        Image decoded;
+        BOOST_CHECK( decoded.decodePng( stream.data(), 4 ) == false );
+        BOOST_CHECK( decoded.decodePng( stream.data(), stream.size() / 2 ) == false );
+        BOOST_CHECK( decoded.empty() );
+    }
+
+    BOOST_AUTO_TEST_CASE( save_auto_palette ) {
+        Image object(37, 20);
+        object.fill( Image::WHITE );
+        object.fillRect(3, 2, 30, 10, Image::RED);
+        object.fillRect(10, 5, 20, 18, Image::TRANSPARENT);
+
+        std::vector<uint8_t> stream;
+        object.encodePng( stream, Image::PF_AUTO );
+        BOOST_CHECK_EQUAL( stream[24], 2 );                 /// IHDR bit depth
+        BOOST_CHECK_EQUAL( stream[25], 3 );                 /// IHDR color type: palette
+        Image decoded;
+        BOOST_CHECK( decoded.decodePng( stream.data(), stream.size() ) );
+        BOOST_CHECK( decoded == object );
+
+        object.fillRect(0, 0, 1, 1, Image::BLUE);
+        object.fillRect(1, 0, 2, 1, Image::GREEN);
+        object.encodePng( stream, Image::PF_AUTO );
+        BOOST_CHECK_EQUAL( stream[24], 4 );
+        BOOST_CHECK( decoded.decodePng( stream.data(), stream.size() ) );
+        BOOST_CHECK( decoded == object );
+
+        /// too many colors
+        for( uint32_t x=0; x<object.width(); ++x ) {
+            for( uint32_t y=0; y<object.height(); ++y ) {
+                object.setPixel( x, y, Image::Pixel(x, y, x + y, 255) );
+            }
+        }
+        object.encodePng( stream, Image::PF_AUTO );
+        BOOST_CHECK_EQUAL( stream[25], 6 );                 /// IHDR color type: RGBA
+        BOOST_CHECK( decoded.decodePng( stream.data(), stream.size() ) );
+        BOOST_CHECK( decoded == object );
+    }
+
+    BOOST_AUTO_TEST_CASE( save_parallel ) {
+        Image object(301, 517);
+        for( uint32_t y=0; y<object.height(); ++y ) {
+            for( uint32_t x=0; x<object.width(); ++x ) {
+                object.setPixel( x, y, Image::Pixel(x, y, x ^ y, (x * y) % 256) );
+            }
+        }
+
+        Image::SaveOptions options;
+        options.threads = 4;
+        std::vector<uint8_t> stream;
+        Image decoded;
+        for (const Image::PixelFormat format: { Image::PF_RGBA32, Image::PF_RGB24, Image::PF_GRAY8 }) {
+            options.format = format;
+            std::vector<uint8_t> expected;
+            object.encodePng( expected, format );
+            Image expectedImage;
+            BOOST_CHECK( expectedImage.decodePng( expected.data(), expected.size() ) );
+
+            object.encodePng( stream, options );
+            BOOST_CHECK( decoded.decodePng( stream.data(), stream.size() ) );
+            BOOST_CHECK( decoded == expectedImage );
+        }
+
+        /// few colors, palette with 2-bit indexes
+        object.fill( Image::WHITE );
+        object.fillRect(10, 10, 200, 400, Image::RED);
+        object.fillRect(50, 100, 300, 500, Image::TRANSPARENT);
+        options.format = Image::PF_AUTO;
+        options.compressionLevel = 9;
+        object.save( "save_parallel.png", options );
+        BOOST_CHECK( Image( "save_parallel.png" ) == object );
+    }
+
+    BOOST_AUTO_TEST_CASE( save_palette_overflow ) {
+        Image object(300, 1);
+        for (uint32_t i=0; i<300; ++i) {
+            object.setPixel(i, 0, Image::Pixel(i % 256, i / 256, 0, 255));
+        }
+        BOOST_CHECK_THROW( object.save( "save_overflow.png", Image::PF_PALETTE8 ), std::invalid_argument );
+    }
+
     BOOST_AUTO_TEST_CASE( compare_differ ) {
         Image object1;
         object1.load("refimg/red.png");
@@ -144,4 +322,93 @@ BOOST_AUTO_TEST_SUITE( ImageSuite )
         BOOST_CHECK_EQUAL( (object1 == object2), false );
     }
 
+    BOOST_AUTO_TEST_CASE( data_aligned ) {
+        const Image object(10, 3);
+        BOOST_CHECK_EQUAL( object.stride() % Image::STRIDE_ALIGNMENT, 0 );
+        BOOST_CHECK_EQUAL( (std::uintptr_t) object.data() % PixelBuffer::ALIGNMENT, 0 );
+        BOOST_CHECK_EQUAL( (std::uintptr_t) object.row(2) % PixelBuffer::ALIGNMENT, 0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( resize_preserve ) {
+        Image object(3, 3);
+        object.fill("red");
+        object.resize(20, 2);
+        BOOST_CHECK_EQUAL(object.width(), 20);
+        BOOST_CHECK_EQUAL(object.height(), 2);
+        BOOST_CHECK( object.pixel(2, 1) == Image::RED );
+        BOOST_CHECK( object.pixel(3, 1) == Image::TRANSPARENT );
+    }
+
+    BOOST_AUTO_TEST_CASE( fillRect_bounds ) {
+        Image object(67, 5);
+        object.fill("white");
+        object.fillRect(3, 1, 61, 4, Image::RED);
+        BOOST_CHECK( object.pixel( 2, 1) == Image::WHITE );
+        BOOST_CHECK( object.pixel( 3, 1) == Image::RED );
+        BOOST_CHECK( object.pixel(60, 3) == Image::RED );
+        BOOST_CHECK( object.pixel(61, 3) == Image::WHITE );
+        BOOST_CHECK( object.pixel(30, 0) == Image::WHITE );
+        BOOST_CHECK( object.pixel(30, 4) == Image::WHITE );
+    }
+
+    BOOST_AUTO_TEST_CASE( pasteImage_clip ) {
+        Image source(40, 40);
+        source.fill("blue");
+        Image object(50, 30);
+        object.fill("white");
+        object.pasteImage(17, 5, source);
+        BOOST_CHECK( object.pixel(16,  5) == Image::WHITE );
+        BOOST_CHECK( object.pixel(17,  4) == Image::WHITE );
+        BOOST_CHECK( object.pixel(17,  5) == Image::BLUE );
+        BOOST_CHECK( object.pixel(49, 29) == Image::BLUE );
+    }
+
+    BOOST_AUTO_TEST_CASE( compare_last_pixel ) {
+        Image object1(33, 7);
+        object1.fill("green");
+        Image object2(33, 7);
+        object2.fill("green");
+        BOOST_CHECK( object1 == object2 );
+        object2.setPixel(32, 6, Image::BLUE);
+        BOOST_CHECK( object1 != object2 );
+    }
+
+    BOOST_AUTO_TEST_CASE( hash_content ) {
+        Image object1(5, 5);
+        object1.fill("red");
+        Image object2(5, 5);
+        object2.fill("red");
+        BOOST_CHECK_EQUAL( object1.hash(), object2.hash() );
+
+        object2.setPixel(4, 4, Image::BLUE);
+        BOOST_CHECK( object1.hash() != object2.hash() );
+        BOOST_CHECK( object1 != object2 );
+
+        object2.setPixel(4, 4, Image::RED);
+        BOOST_CHECK_EQUAL( object1.hash(), object2.hash() );
+        BOOST_CHECK( object1 == object2 );
+    }
+
+    BOOST_AUTO_TEST_CASE( compare_after_view_write ) {
+        Image object1(5, 5);
+        object1.fill("red");
+        Image object2(5, 5);
+        object2.fill("blue");
+        const ImageView view( object2 );
+        BOOST_CHECK( object1.hash() != object2.hash() );
+
+        view.fill( Image::RED );
+        BOOST_CHECK_EQUAL( object1.hash(), object2.hash() );
+        BOOST_CHECK( object1 == object2 );
+    }
+
+    BOOST_AUTO_TEST_CASE( copy ) {
+        Image object(4, 4);
+        object.fill("blue");
+        Image copy( object );
+        BOOST_CHECK( copy == object );
+        copy.setPixel(1, 1, Image::RED);
+        BOOST_CHECK( copy != object );
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,75 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "imgdraw2d/MappedImage.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+
+
+using namespace imgdraw2d;
+
+
+BOOST_AUTO_TEST_SUITE( MappedImageSuite )
+
+    BOOST_AUTO_TEST_CASE( save_load ) {
+        Image object(21, 7);
+        object.fill( Image::WHITE );
+        object.fillRect(3, 2, 10, 5, Image::RED);
+        object.saveRaw( "raw/save_load.raw" );
+
+        Image loaded;
+        BOOST_CHECK( loaded.loadRaw( "raw/save_load.raw" ) );
+        BOOST_CHECK( loaded == object );
+    }
+
+    BOOST_AUTO_TEST_CASE( map_view ) {
+        Image object(5, 40);
+        object.fill( Image::BLUE );
+        object.setPixel(4, 39, Image::GREEN);
+        object.saveRaw( "raw/map_view.raw" );
+
+        const MappedImage mapped( "raw/map_view.raw" );
+        BOOST_REQUIRE( mapped.empty() == false );
+        BOOST_CHECK_EQUAL( mapped.width(), 5 );
+        BOOST_CHECK_EQUAL( mapped.height(), 40 );
+        BOOST_CHECK( mapped.view().equals( object ) );
+        BOOST_CHECK( mapped.view().pixel(4, 39) == Image::GREEN );
+    }
+
+    BOOST_AUTO_TEST_CASE( invalid_file ) {
+        {
+            std::ofstream output( "raw/invalid.raw" );
+            output << "not an image";
+        }
+        Image loaded;
+        BOOST_CHECK( loaded.loadRaw( "raw/invalid.raw" ) == false );
+        BOOST_CHECK( loaded.loadRaw( "raw/missing.raw" ) == false );
+
+        MappedImage mapped;
+        BOOST_CHECK( mapped.open( "raw/invalid.raw" ) == false );
+        BOOST_CHECK( mapped.empty() );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -42,6 +42,18 @@ BOOST_AUTO_TEST_SUITE( PainterSuite )
         CHECK_IMAGE( image );
     }
 
+    BOOST_AUTO_TEST_CASE( fillCircle_border ) {
+        Image image(200, 200);
+        Painter painter( image );
+        painter.fillCircle( 10, 20, 40, "red" );
+        painter.fillCircle( 190, 190, 30, "blue" );
+        painter.fillCircle( 100, 100, 1, "black" );
+        painter.fillCircle( 100, 140, 0, "black" );
+        painter.fillCircle( PointI(-30, 150), 45, Image::GREEN );
+
+        CHECK_IMAGE( image );
+    }
+
     BOOST_AUTO_TEST_CASE( fillRect_01 ) {
         Image image(400, 400);
         Painter painter( image );
@@ -62,6 +74,62 @@ BOOST_AUTO_TEST_SUITE( PainterSuite )
         CHECK_IMAGE( image );
     }
 
+    BOOST_AUTO_TEST_CASE( fillPolygon_rect ) {
+        Image image(200, 200);
+        Painter painter( image );
+        const std::vector<PointI> polygon{ PointI(50, 40), PointI(150, 40), PointI(150, 120), PointI(50, 120) };
+        painter.fillPolygon( polygon, Image::BLUE );
+
+        Image expected(200, 200);
+        Painter expectedPainter( expected );
+        expectedPainter.fillRect( 50, 40, 100, 80, "blue" );
+
+        BOOST_CHECK( image == expected );
+    }
+
+    BOOST_AUTO_TEST_CASE( fillPolygon_difference ) {
+        Image image(200, 200);
+        image.fill( Image::WHITE );
+        Painter painter( image );
+        painter.setCompositionMode( Painter::CM_DIFFERENCE );
+        const std::vector<PointI> polygon{ PointI(50, 40), PointI(150, 40), PointI(150, 120), PointI(50, 120) };
+        painter.fillPolygon( polygon, Image::BLUE );
+        painter.fillPolygon( polygon, Image::RED );
+
+        Image expected(200, 200);
+        expected.fill( Image::WHITE );
+        Painter expectedPainter( expected );
+        expectedPainter.setCompositionMode( Painter::CM_DIFFERENCE );
+        expectedPainter.fillRect( 50, 40, 100, 80, "blue" );
+        expectedPainter.fillRect( 50, 40, 100, 80, "red" );
+
+        BOOST_CHECK( image == expected );
+        BOOST_CHECK( image.pixel( 50, 40 ) != Image::WHITE );
+    }
+
+    BOOST_AUTO_TEST_CASE( fillPolygon_mixed ) {
+        Image image(300, 300);
+        Painter painter( image );
+
+        /// self-intersecting star, center is not filled
+        std::vector<PointI> star;
+        for( uint32_t i=0; i<5; ++i ) {
+            const double angle = i * 4.0 * M_PI / 5.0 - M_PI / 2.0;
+            star.push_back( PointI( 100 + 90 * std::cos( angle ), 100 + 90 * std::sin( angle ) ) );
+        }
+        painter.fillPolygon( star, Image::BLUE );
+
+        /// concave polygon crossing canvas border
+        const std::vector<PointI> arrow{ PointI(180, 200), PointI(340, 260), PointI(180, 320), PointI(230, 260) };
+        painter.fillPolygon( arrow, Image::RED );
+
+        /// rotated rectangle given in opposite order
+        const std::vector<PointI> rect{ PointI(40, 230), PointI(120, 290), PointI(140, 262), PointI(60, 202) };
+        painter.fillPolygon( rect, "green" );
+
+        CHECK_IMAGE( image );
+    }
+
     BOOST_AUTO_TEST_CASE( drawLine_horizontal_1 ) {
         Image image(220, 140);
         Painter painter( image );
@@ -118,6 +186,23 @@ BOOST_AUTO_TEST_SUITE( PainterSuite )
         CHECK_IMAGE( image );
     }
 
+    BOOST_AUTO_TEST_CASE( drawLine_mixed ) {
+        Image image(300, 300);
+        Painter painter( image );
+        const uint32_t widths[] = { 1, 2, 3, 5, 8, 13 };
+        for( uint32_t i=0; i<36; ++i ) {
+            const double angle = i * M_PI / 18.0 + 0.1;
+            const PointI from( 150 + 40 * std::cos( angle ), 150 + 40 * std::sin( angle ) );
+            const PointI to( 150 + 170 * std::cos( angle ), 150 + 170 * std::sin( angle ) );
+            painter.drawLine( from, to, widths[ i % 6 ], (i % 2 == 0) ? Image::BLUE : Image::RED );
+        }
+        painter.drawLine( PointI(-20, 10), PointI(40, -30), 6, Image::GREEN );
+        painter.drawLine( PointI(150, 150), PointI(150, 150), 4, Image::BLACK );
+        painter.drawLine( PointI(140, 160), PointI(141, 190), 1, Image::BLACK );
+
+        CHECK_IMAGE( image );
+    }
+
     BOOST_AUTO_TEST_CASE( drawRing_thin ) {
         Image image(140, 140);
         Painter painter( image );
@@ -126,6 +211,17 @@ BOOST_AUTO_TEST_SUITE( PainterSuite )
         CHECK_IMAGE( image );
     }
 
+    BOOST_AUTO_TEST_CASE( drawArc_clipped ) {
+        Image image(200, 200);
+        Painter painter( image );
+        painter.drawArc( PointI{-100, 250}, 300, 1, -1.2, 1.0, "blue" );
+        painter.drawArc( PointI{-100, 250}, 250, 12, 0.3, -1.4, "red" );
+        painter.drawArc( PointI{150, 60}, 90, 4, 2.0, 4.0, Image::GREEN );
+        painter.drawRing( PointI{200, 200}, 60, 9, "black" );
+
+        CHECK_IMAGE( image );
+    }
+
     BOOST_AUTO_TEST_CASE( drawArc_full_positive ) {
         {
             Image image(140, 140);
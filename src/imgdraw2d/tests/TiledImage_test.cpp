@@ -0,0 +1,128 @@
+/// MIT License
+///
+/// Copyright (c) 2019 Arkadiusz Netczuk <dev.arnet@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+///
+
+#include "imgdraw2d/TiledImage.h"
+#include "imgdraw2d/Painter.h"
+
+#include "ImgTestUtils.h"
+
+
+using namespace imgdraw2d;
+
+
+BOOST_AUTO_TEST_SUITE( TiledImageSuite )
+
+    BOOST_AUTO_TEST_CASE( tileIndex ) {
+        TiledImage canvas( 16 );
+        BOOST_CHECK_EQUAL( canvas.tileIndex(   0 ),  0 );
+        BOOST_CHECK_EQUAL( canvas.tileIndex(  15 ),  0 );
+        BOOST_CHECK_EQUAL( canvas.tileIndex(  16 ),  1 );
+        BOOST_CHECK_EQUAL( canvas.tileIndex(  -1 ), -1 );
+        BOOST_CHECK_EQUAL( canvas.tileIndex( -16 ), -1 );
+        BOOST_CHECK_EQUAL( canvas.tileIndex( -17 ), -2 );
+    }
+
+    BOOST_AUTO_TEST_CASE( flatten_background ) {
+        TiledImage canvas( 16, Image::WHITE );
+        canvas.tile( -1, 0 ).fill( Image::RED );
+
+        ImagePtr image = canvas.flatten( RectI( -4, -4, 3, 3 ) );
+        BOOST_CHECK_EQUAL( image->width(), 8 );
+        BOOST_CHECK_EQUAL( image->height(), 8 );
+        BOOST_CHECK( image->pixel( 0, 0 ) == Image::WHITE );
+        BOOST_CHECK( image->pixel( 3, 4 ) == Image::RED );
+        BOOST_CHECK( image->pixel( 4, 4 ) == Image::WHITE );
+        BOOST_CHECK_EQUAL( canvas.size(), 1 );
+    }
+
+    BOOST_AUTO_TEST_CASE( paint_tiles ) {
+        Image image( 100, 80 );
+        Painter painter( image );
+        TiledImage canvas( 16 );
+        Painter tilesPainter( canvas );
+
+        /// canvas origin is in the middle of image
+        const PointI origin( 37, 29 );
+        for (Painter* item: { &painter, &tilesPainter }) {
+            const PointI offset = (item == &painter) ? PointI(0, 0) : origin;
+            item->drawLine( PointI(3, 5) - offset, PointI(90, 70) - offset, 5, "blue" );
+            item->fillCircle( PointI(40, 30) - offset, 20, "red" );
+            item->drawRing( PointI(60, 40) - offset, 25, 3, "green" );
+            item->drawArc( PointI(30, 50) - offset, 20, 4, 0.5, 4.0, "orange" );
+            item->fillRect( PointI(70, 2) - offset, 20, 30, "black" );
+        }
+
+        ImagePtr result = canvas.flatten( RectI( -origin, -origin + PointI(99, 79) ) );
+        IMAGES_COMPARE( *result, image, "tiledimage" );
+    }
+
+    BOOST_AUTO_TEST_CASE( sparse_tiles ) {
+        TiledImage canvas( 16, Image::WHITE );
+        Painter painter( canvas );
+
+        /// bounding box of ring covers 49 tiles, ring touches only border ones
+        painter.drawRing( PointI(0, 0), 50, 2, "blue" );
+        BOOST_CHECK( canvas.size() < 49 );
+        BOOST_CHECK( canvas.findTile( 0, 0 ) == nullptr );
+        BOOST_CHECK( canvas.findTile( 3, 0 ) != nullptr );
+
+        /// drawing background color does not allocate tiles
+        const std::size_t allocated = canvas.size();
+        painter.fillRect( PointI(-20, -20), 40, 40, Image::WHITE );
+        BOOST_CHECK_EQUAL( canvas.size(), allocated );
+    }
+
+    BOOST_AUTO_TEST_CASE( sparse_tiles_diagonal ) {
+        TiledImage canvas( 16, Image::WHITE );
+        Painter painter( canvas );
+
+        /// bounding box of line covers 63 x 63 tiles, line touches only tiles along diagonal
+        painter.drawLine( PointI(0, 0), PointI(1000, 1000), 3, "blue" );
+        BOOST_CHECK( canvas.size() < 3 * 63 );
+        BOOST_CHECK( canvas.findTile( 0, 0 ) != nullptr );
+        BOOST_CHECK( canvas.findTile( 62, 62 ) != nullptr );
+        BOOST_CHECK( canvas.findTile( 62, 0 ) == nullptr );
+
+        /// difference mode marks tiles from written spans as well
+        painter.setCompositionMode( Painter::CM_DIFFERENCE );
+        painter.fillRect( PointI(500, 20), 3, 3, Image::RED );
+        BOOST_CHECK( canvas.findTile( 31, 1 ) != nullptr );
+        BOOST_CHECK( canvas.findTile( 30, 1 ) == nullptr );
+    }
+
+    BOOST_AUTO_TEST_CASE( save_bands ) {
+        TiledImage canvas( 16, Image::WHITE );
+        Painter painter( canvas );
+        painter.drawLine( PointI(-30, -25), PointI(40, 33), 3, "red" );
+        painter.fillCircle( PointI(10, -10), 8, "green" );
+
+        const RectI area( -35, -30, 44, 37 );
+        canvas.save( "tiledimage/save_bands.png", area );
+        canvas.save( "tiledimage/save_bands_palette.png", area, Image::PF_PALETTE8 );
+
+        const ImagePtr expected = canvas.flatten( area );
+        BOOST_CHECK( Image( "tiledimage/save_bands.png" ) == *expected );
+        BOOST_CHECK( Image( "tiledimage/save_bands_palette.png" ) == *expected );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()